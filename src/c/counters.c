@@ -0,0 +1,68 @@
+#include "counters.h"
+#include "message_keys.auto.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_COUNTERS
+#include "log.h"
+
+#ifndef MESSAGE_KEY_COUNTERS
+#define MESSAGE_KEY_COUNTERS 10021
+#endif
+
+/* Persist keys 200+ belong to this module */
+#define PERSIST_KEY_COUNTERS 200
+
+/* Persisted record; a different version or size starts from zero */
+typedef struct {
+  uint8_t version;
+  uint8_t count;
+  uint32_t since;
+  uint32_t values[COUNTER_COUNT];
+} counters_record_t;
+
+/* Internal state */
+static counters_record_t s_record;
+
+void counters_init(void) {
+  int read = persist_read_data(PERSIST_KEY_COUNTERS, &s_record, sizeof(s_record));
+  if (read != (int)sizeof(s_record) || s_record.version != COUNTERS_REPORT_VERSION || s_record.count != COUNTER_COUNT) {
+    memset(&s_record, 0, sizeof(s_record));
+    s_record.version = COUNTERS_REPORT_VERSION;
+    s_record.count = COUNTER_COUNT;
+    s_record.since = (uint32_t)time(NULL);
+  }
+}
+
+void counters_persist(void) {
+  if (persist_write_data(PERSIST_KEY_COUNTERS, &s_record, sizeof(s_record)) < 0) {
+    LOG_WARN("Failed to persist counters");
+  }
+}
+
+void counters_add(counter_t counter, uint32_t n) {
+  s_record.values[counter] += n;
+}
+
+void counters_inc(counter_t counter) {
+  s_record.values[counter]++;
+}
+
+uint32_t counters_get(counter_t counter) {
+  return s_record.values[counter];
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = (v >> 24) & 0xFF;
+  return p + 4;
+}
+
+void counters_write_report(DictionaryIterator *iter) {
+  uint8_t report[COUNTERS_REPORT_SIZE];
+  uint8_t *p = report;
+  *p++ = COUNTERS_REPORT_VERSION;
+  *p++ = COUNTER_COUNT;
+  p = put_u32(p, s_record.since);
+  for (int i = 0; i < COUNTER_COUNT; ++i) p = put_u32(p, s_record.values[i]);
+  dict_write_data(iter, MESSAGE_KEY_COUNTERS, report, sizeof(report));
+}
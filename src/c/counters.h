@@ -0,0 +1,58 @@
+/* counters.h
+ * Performance counters for field diagnostics.
+ *
+ * Fixed uint32 slots counting what the face does on a real watch: redraws,
+ * AppMessage traffic, the weather module's radio and timer cost, tick
+ * wakeups and the time spent formatting updates. The counts are cumulative
+ * across launches. They are saved daily and on exit, and are sent to the
+ * companion as one COUNTERS byte array when it asks, to tune polling and
+ * rendering against real use.
+ */
+
+#pragma once
+
+#include <pebble.h>
+#include "render_slots.h"
+
+typedef enum {
+  COUNTER_REDRAWS,        /* first of RENDER_SLOT_COUNT: invalidations per render slot */
+  COUNTER_INBOX_MESSAGES = COUNTER_REDRAWS + RENDER_SLOT_COUNT,
+  COUNTER_INBOX_BYTES,    /* dictionary bytes received */
+  COUNTER_OUTBOX_SENT,    /* messages delivered to the phone */
+  COUNTER_OUTBOX_FAILED,  /* messages that were not, or the outbox refused */
+  COUNTER_RETRIES,        /* weather request retries scheduled */
+  COUNTER_COOLDOWN_SKIPS, /* weather requests refused by the cooldown */
+  COUNTER_TICK_WAKEUPS,   /* tick service callbacks */
+  COUNTER_UPDATES,        /* prv_format_and_update_weather() passes with changes to draw */
+  COUNTER_UPDATE_MS,      /* milliseconds spent in them */
+  COUNTER_WEATHER_REQUESTS,   /* weather requests handed to the outbox */
+  COUNTER_WEATHER_TIMERS,     /* weather retry/backoff AppTimers registered */
+  COUNTER_WEATHER_WAKEUPS,    /* tick, BT and timer callbacks entering the weather module */
+  COUNTER_DELTAS_APPLIED,     /* WEATHER_DELTA payloads applied (incl. unchanged) */
+  COUNTER_DELTA_MISMATCHES,   /* deltas dropped because the base hash differed */
+  COUNTER_REQUESTS_COALESCED, /* weather triggers merged into an in-flight request */
+  COUNTER_RESPONSE_TIMEOUTS,  /* weather requests that never got a reply */
+  COUNTER_COUNT
+} counter_t;
+
+/* COUNTERS byte array, little-endian:
+ *   [0]      version (COUNTERS_REPORT_VERSION)
+ *   [1]      counter count N
+ *   [2..5]   uint32 UTC time counting started
+ *   [6..]    N x uint32 in counter_t order
+ */
+#define COUNTERS_REPORT_VERSION 1
+#define COUNTERS_REPORT_SIZE (6 + COUNTER_COUNT * 4)
+
+/* Restore the persisted counts, or start counting now. */
+void counters_init(void);
+
+/* Save the counts. Call once a day and on exit. */
+void counters_persist(void);
+
+void counters_add(counter_t counter, uint32_t n);
+void counters_inc(counter_t counter);
+uint32_t counters_get(counter_t counter);
+
+/* Add the counts as a COUNTERS byte array to an outgoing message. */
+void counters_write_report(DictionaryIterator *iter);
@@ -0,0 +1,136 @@
+#include "event_bus.h"
+#include "counters.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_BUS
+#include "log.h"
+
+/* Internal state */
+static event_bus_listener_t s_listeners[EVENT_BUS_MAX_LISTENERS];
+static bool s_used[EVENT_BUS_MAX_LISTENERS];
+static bool s_bt_subscribed = false;
+static bool s_battery_subscribed = false;
+static bool s_bt_connected = false;
+static BatteryChargeState s_battery;
+
+static bool battery_equal(BatteryChargeState a, BatteryChargeState b) {
+  return a.charge_percent == b.charge_percent && a.is_charging == b.is_charging && a.is_plugged == b.is_plugged;
+}
+
+static void bus_bt_handler(bool connected) {
+  if (connected == s_bt_connected) return;
+  s_bt_connected = connected;
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (s_used[i] && s_listeners[i].bt) s_listeners[i].bt(connected, s_listeners[i].ctx);
+  }
+}
+
+static void bus_battery_handler(BatteryChargeState state) {
+  if (battery_equal(state, s_battery)) return;
+  s_battery = state;
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (s_used[i] && s_listeners[i].battery) s_listeners[i].battery(state, s_listeners[i].ctx);
+  }
+}
+
+static void bus_inbox_received(DictionaryIterator *iter, void *context) {
+  counters_inc(COUNTER_INBOX_MESSAGES);
+  counters_add(COUNTER_INBOX_BYTES, dict_size(iter));
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (s_used[i] && s_listeners[i].inbox) s_listeners[i].inbox(iter, s_listeners[i].ctx);
+  }
+}
+
+static void bus_inbox_dropped(AppMessageResult reason, void *context) {
+  LOG_ERROR("AppMessage dropped: %d", (int)reason);
+}
+
+static void bus_outbox_sent(DictionaryIterator *iter, void *context) {
+  counters_inc(COUNTER_OUTBOX_SENT);
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (s_used[i] && s_listeners[i].outbox_sent) s_listeners[i].outbox_sent(iter, s_listeners[i].ctx);
+  }
+}
+
+static void bus_outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  LOG_ERROR("Outbox send failed: %d", (int)reason);
+  counters_inc(COUNTER_OUTBOX_FAILED);
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (s_used[i] && s_listeners[i].outbox_failed) s_listeners[i].outbox_failed(iter, reason, s_listeners[i].ctx);
+  }
+}
+
+/* Stay subscribed to BT and battery only while some listener wants them.
+   The cached state is refreshed on subscribe since no events were seen
+   while unsubscribed. */
+static void update_subscriptions(void) {
+  bool want_bt = false, want_battery = false;
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (!s_used[i]) continue;
+    want_bt |= s_listeners[i].bt != NULL;
+    want_battery |= s_listeners[i].battery != NULL;
+  }
+  if (want_bt != s_bt_subscribed) {
+    if (want_bt) {
+      s_bt_connected = bluetooth_connection_service_peek();
+      bluetooth_connection_service_subscribe(bus_bt_handler);
+    } else {
+      bluetooth_connection_service_unsubscribe();
+    }
+    s_bt_subscribed = want_bt;
+  }
+  if (want_battery != s_battery_subscribed) {
+    if (want_battery) {
+      s_battery = battery_state_service_peek();
+      battery_state_service_subscribe(bus_battery_handler);
+    } else {
+      battery_state_service_unsubscribe();
+    }
+    s_battery_subscribed = want_battery;
+  }
+}
+
+void event_bus_init(void) {
+  memset(s_listeners, 0, sizeof(s_listeners));
+  memset(s_used, 0, sizeof(s_used));
+  s_bt_subscribed = s_battery_subscribed = false;
+  s_bt_connected = bluetooth_connection_service_peek();
+  s_battery = battery_state_service_peek();
+  app_message_register_inbox_received(bus_inbox_received);
+  app_message_register_inbox_dropped(bus_inbox_dropped);
+  app_message_register_outbox_failed(bus_outbox_failed);
+  app_message_register_outbox_sent(bus_outbox_sent);
+}
+
+void event_bus_deinit(void) {
+  memset(s_used, 0, sizeof(s_used));
+  update_subscriptions();
+  app_message_deregister_callbacks();
+}
+
+int event_bus_subscribe(const event_bus_listener_t *listener) {
+  if (!listener) return -1;
+  for (int i = 0; i < EVENT_BUS_MAX_LISTENERS; ++i) {
+    if (!s_used[i]) {
+      s_listeners[i] = *listener;
+      s_used[i] = true;
+      update_subscriptions();
+      return i;
+    }
+  }
+  LOG_ERROR("event_bus: no free listener slot");
+  return -1;
+}
+
+void event_bus_unsubscribe(int handle) {
+  if (handle < 0 || handle >= EVENT_BUS_MAX_LISTENERS) return;
+  s_used[handle] = false;
+  memset(&s_listeners[handle], 0, sizeof(s_listeners[handle]));
+  update_subscriptions();
+}
+
+bool event_bus_bt_connected(void) {
+  return s_bt_connected;
+}
+
+BatteryChargeState event_bus_battery(void) {
+  return s_battery;
+}
@@ -0,0 +1,56 @@
+/* event_bus.h
+ * Single owner of the Bluetooth, battery and AppMessage service callbacks.
+ *
+ * Like the tick service, each of these Pebble services keeps only one
+ * handler per app: a second bluetooth_connection_service_subscribe()
+ * silently replaces the first, and an unsubscribe from one module cuts off
+ * every other. Modules therefore register a listener here instead. The bus
+ * subscribes to a service while at least one listener wants it and fans
+ * each event out to all of them.
+ *
+ * Bluetooth and battery events that don't change the state (same connection
+ * state, same charge percent and charger state) are dropped, so listeners
+ * only wake for real transitions.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+/* Maximum number of simultaneous listeners (app, weather, ...). */
+#define EVENT_BUS_MAX_LISTENERS 4
+
+/* Callbacks a listener wants; leave the others NULL. `ctx` is passed back
+ * to each of them.
+ */
+typedef struct {
+  void (*bt)(bool connected, void *ctx);
+  void (*battery)(BatteryChargeState state, void *ctx);
+  void (*inbox)(DictionaryIterator *iter, void *ctx);
+  void (*outbox_sent)(DictionaryIterator *iter, void *ctx);
+  void (*outbox_failed)(DictionaryIterator *iter, AppMessageResult reason, void *ctx);
+  void *ctx;
+} event_bus_listener_t;
+
+/* Reset the registry, read the current BT and battery state and register
+ * the AppMessage callbacks. Call once before app_message_open() and before
+ * any module subscribes.
+ */
+void event_bus_init(void);
+
+/* Drop all listeners and release every service subscription. */
+void event_bus_deinit(void);
+
+/* Register a listener (copied). Returns a handle >= 0, or -1 when the
+ * registry is full.
+ */
+int event_bus_subscribe(const event_bus_listener_t *listener);
+
+/* Remove a listener. Unknown or negative handles are ignored. */
+void event_bus_unsubscribe(int handle);
+
+/* Last known state, kept current by the bus; cheaper than the service
+ * peeks and consistent with what listeners were told.
+ */
+bool event_bus_bt_connected(void);
+BatteryChargeState event_bus_battery(void);
@@ -0,0 +1,60 @@
+#include "font_registry.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_FONTS
+#include "log.h"
+#include "mem_stats.h"
+
+/* Custom fonts only exist for the platforms listed with them in
+   package.json; elsewhere the role falls back to its system font. Resource
+   IDs start at 1, so 0 means "not in this build". */
+#ifdef RESOURCE_ID_FONT_LECO_47
+#define TIME_FONT_RESOURCE RESOURCE_ID_FONT_LECO_47
+#else
+#define TIME_FONT_RESOURCE 0
+#endif
+#ifdef RESOURCE_ID_FONT_WEATHER_12
+#define GLYPH_FONT_RESOURCE RESOURCE_ID_FONT_WEATHER_12
+#else
+#define GLYPH_FONT_RESOURCE 0
+#endif
+
+typedef struct {
+  uint32_t resource_id;    /* custom font, 0 for none */
+  const char *system_font; /* used when there is no custom font */
+} font_entry_t;
+
+static const font_entry_t s_entries[FACE_FONT_COUNT] = {
+  [FACE_FONT_TIME]        = { TIME_FONT_RESOURCE,  FONT_KEY_ROBOTO_BOLD_SUBSET_49 },
+  [FACE_FONT_DATE]        = { 0,                   FONT_KEY_GOTHIC_24_BOLD },
+  [FACE_FONT_GLYPH]       = { GLYPH_FONT_RESOURCE, FONT_KEY_GOTHIC_18 },
+  [FACE_FONT_ICON_CODE]   = { 0,                   FONT_KEY_ROBOTO_CONDENSED_21 },
+  [FACE_FONT_TEMPERATURE] = { 0,                   FONT_KEY_GOTHIC_18_BOLD },
+  [FACE_FONT_METRIC]      = { 0,                   FONT_KEY_GOTHIC_18 },
+  [FACE_FONT_SUN]         = { 0,                   FONT_KEY_GOTHIC_14 },
+};
+
+/* Internal state */
+static GFont s_loaded[FACE_FONT_COUNT]; /* custom fonts currently loaded */
+static uint8_t s_refs[FACE_FONT_COUNT];
+
+GFont font_registry_acquire(face_font_t font) {
+  const font_entry_t *entry = &s_entries[font];
+  s_refs[font]++;
+  if (!entry->resource_id) return fonts_get_system_font(entry->system_font);
+  if (!s_loaded[font]) {
+#if LOG_ENABLED(LOG_LEVEL_INFO)
+    size_t before = heap_bytes_used();
+#endif
+    s_loaded[font] = fonts_load_custom_font(resource_get_handle(entry->resource_id));
+    mem_stats_sample(MEM_CHECKPOINT_FONT_LOAD);
+    LOG_INFO("Font %d loaded: %d bytes of heap", (int)font, (int)(heap_bytes_used() - before));
+  }
+  return s_loaded[font] ? s_loaded[font] : fonts_get_system_font(entry->system_font);
+}
+
+void font_registry_release(face_font_t font) {
+  if (!s_refs[font]) return;
+  if (--s_refs[font] == 0 && s_loaded[font]) {
+    fonts_unload_custom_font(s_loaded[font]);
+    s_loaded[font] = NULL;
+  }
+}
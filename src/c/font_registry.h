@@ -0,0 +1,33 @@
+/* font_registry.h
+ * The fonts the face draws with, loaded on demand and reference counted.
+ *
+ * Each complication asks for a font role rather than a resource. The
+ * registry maps the role to a custom font resource (when the platform's
+ * build has it) or a system font, loads custom fonts on first acquire and
+ * unloads them when the last user releases them. Only fonts that are
+ * actually on screen cost heap. The build prints which font resources the
+ * code references (see report_font_resources in wscript).
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+typedef enum {
+  FACE_FONT_TIME,        /* LECO 47 digits; Roboto Bold 49 without it */
+  FACE_FONT_DATE,        /* Gothic 24 Bold */
+  FACE_FONT_GLYPH,       /* WeatherIcons 12; Gothic 18 without it */
+  FACE_FONT_ICON_CODE,   /* Roboto Condensed 21 */
+  FACE_FONT_TEMPERATURE, /* Gothic 18 Bold */
+  FACE_FONT_METRIC,      /* Gothic 18: humidity, min/max, status */
+  FACE_FONT_SUN,         /* Gothic 14 */
+  FACE_FONT_COUNT
+} face_font_t;
+
+/* Get a role's font, loading it on first use. Every acquire must be matched
+ * by a font_registry_release().
+ */
+GFont font_registry_acquire(face_font_t font);
+
+/* Drop one reference; a custom font is unloaded with its last reference. */
+void font_registry_release(face_font_t font);
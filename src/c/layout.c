@@ -0,0 +1,69 @@
+#include "layout.h"
+
+/* Every frame is checked against the screen at compile time: it must lie
+   within the screen horizontally and end above its bottom edge. Frames may
+   start above the top edge (the top row is pulled up to trim the font's
+   internal leading). */
+#define FRAME(x, y, w, h) { \
+  { (x), (y) + 0 * (int)sizeof(char[((x) >= 0 && (x) + (w) <= SCREEN_W && (y) + (h) <= SCREEN_H) ? 1 : -1]) }, \
+  { (w), (h) } }
+
+#if defined(PBL_PLATFORM_CHALK)
+/* Round 180x180: rows are inset to stay inside the circle at their height,
+   and the sky glyph sits above the temperature instead of beside it. */
+#define SCREEN_W 180
+#define SCREEN_H 180
+static const face_layout_t s_layout = {
+  .sky_glyph   = FRAME(82, 4, 16, 16),
+  .humidity    = FRAME(34, 20, 34, 20),
+  .temperature = FRAME(70, 20, 34, 20),
+  .minmax      = FRAME(104, 20, 42, 20),
+  .date        = FRAME(30, 40, 130, 26),
+  .time        = FRAME(0, 64, 180, 52),
+  .icon_glyph  = FRAME(46, 118, 20, 22),
+  .icon_test   = FRAME(70, 116, 70, 26),
+  .sunrise     = FRAME(32, 142, 58, 14),
+  .sunset      = FRAME(90, 142, 58, 14),
+  .status      = FRAME(40, 156, 100, 18),
+};
+#elif defined(PBL_PLATFORM_EMERY)
+#define SCREEN_W 200
+#define SCREEN_H 228
+static const face_layout_t s_layout = {
+  .sky_glyph   = FRAME(60, 0, 16, 16),
+  .humidity    = FRAME(0, -4, 60, 20),
+  .temperature = FRAME(80, -4, 60, 20),
+  .minmax      = FRAME(114, -4, 86, 20),
+  .date        = FRAME(0, 52, 200, 28),
+  .time        = FRAME(0, 84, 200, 60),
+  .icon_glyph  = FRAME(6, 148, 20, 24),
+  .icon_test   = FRAME(32, 146, 168, 28),
+  .sunrise     = FRAME(4, 212, 96, 14),
+  .sunset      = FRAME(100, 212, 96, 14),
+  .status      = FRAME(50, 208, 100, 18),
+};
+#elif defined(PBL_PLATFORM_APLITE) || defined(PBL_PLATFORM_BASALT) || \
+      defined(PBL_PLATFORM_DIORITE) || defined(PBL_PLATFORM_FLINT)
+/* Rectangular 144x168 */
+#define SCREEN_W 144
+#define SCREEN_H 168
+static const face_layout_t s_layout = {
+  .sky_glyph   = FRAME(32, 0, 16, 16),
+  .humidity    = FRAME(0, -4, 60, 20),
+  .temperature = FRAME(52, -4, 60, 20),
+  .minmax      = FRAME(58, -4, 86, 20),
+  .date        = FRAME(0, 22, 144, 28),
+  .time        = FRAME(0, 54, 144, 60),
+  .icon_glyph  = FRAME(6, 118, 20, 24),
+  .icon_test   = FRAME(32, 116, 112, 28),
+  .sunrise     = FRAME(4, 152, 68, 14),
+  .sunset      = FRAME(72, 152, 68, 14),
+  .status      = FRAME(36, 148, 72, 18),
+};
+#else
+#error "No layout table for this platform; add one to layout.c"
+#endif
+
+const face_layout_t *layout_get(void) {
+  return &s_layout;
+}
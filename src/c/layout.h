@@ -0,0 +1,30 @@
+/* layout.h
+ * Frames of every complication, one const table per watch platform.
+ *
+ * The table is picked at compile time from the PBL_PLATFORM_* define of the
+ * platform being built (see targetPlatforms in package.json), so window load
+ * does no geometry math and each screen (144x168 rectangular, 180x180 round
+ * chalk, 200x228 emery) gets its own pixel positions rather than a scaled
+ * version of another.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+typedef struct {
+  GRect time;
+  GRect date;
+  GRect icon_glyph;  /* WeatherIcons glyph left of the icon code */
+  GRect icon_test;   /* raw OWM icon code */
+  GRect sky_glyph;
+  GRect temperature; /* initial frame; re-centered as the text width changes */
+  GRect humidity;
+  GRect minmax;
+  GRect sunrise;
+  GRect sunset;
+  GRect status;
+} face_layout_t;
+
+/* The layout table for the platform this binary was built for. */
+const face_layout_t *layout_get(void);
@@ -0,0 +1,46 @@
+#define LOG_MODULE_LEVEL LOG_LEVEL_DEFAULT
+#include "log.h"
+
+#if LOG_RING_SIZE > 0
+
+#include <stdarg.h>
+
+typedef struct {
+  time_t time;
+  AppLogLevel level;
+  char text[LOG_RING_TEXT];
+} log_record_t;
+
+/* Internal state */
+static log_record_t s_ring[LOG_RING_SIZE];
+static uint16_t s_next = 0;  /* slot the next record goes to */
+static uint16_t s_count = 0; /* records held, up to LOG_RING_SIZE */
+
+void log_ring_write(AppLogLevel level, const char *fmt, ...) {
+  log_record_t *rec = &s_ring[s_next];
+  rec->time = time(NULL);
+  rec->level = level;
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(rec->text, sizeof(rec->text), fmt, args);
+  va_end(args);
+  s_next = (s_next + 1) % LOG_RING_SIZE;
+  if (s_count < LOG_RING_SIZE) s_count++;
+}
+
+void log_dump(void) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "log ring: %d records", (int)s_count);
+  int first = (s_next + LOG_RING_SIZE - s_count) % LOG_RING_SIZE;
+  for (int n = 0; n < s_count; ++n) {
+    const log_record_t *rec = &s_ring[(first + n) % LOG_RING_SIZE];
+    APP_LOG(rec->level, "[%lu] %s", (unsigned long)rec->time, rec->text);
+  }
+  s_next = s_count = 0;
+}
+
+#else
+
+void log_dump(void) {
+}
+
+#endif
@@ -0,0 +1,112 @@
+/* log.h
+ * Logging with compile-time levels per module.
+ *
+ * Each module picks its level before including this header:
+ *
+ *   #define LOG_MODULE_LEVEL LOG_LEVEL_WEATHER
+ *   #include "log.h"
+ *
+ * and logs with LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG. A call above the
+ * module's level expands to nothing: the format string isn't linked in and
+ * the arguments aren't evaluated. Levels come from `--log-levels` in
+ * wscript (e.g. `weather=debug,router=none`); otherwise every module uses
+ * LOG_LEVEL_DEFAULT, which is warnings in release builds and everything in
+ * debug builds.
+ *
+ * With LOG_RING_SIZE set (`--log-ring` in wscript) records are not sent
+ * over the log channel as they happen but kept in a RAM ring of the last
+ * LOG_RING_SIZE records; log_dump() writes them out on demand.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL_DEFAULT
+#ifdef RELEASE_BUILD
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_WARN
+#else
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_DEBUG
+#endif
+#endif
+
+/* Module levels; keep in sync with LOG_MODULES in wscript */
+#ifndef LOG_LEVEL_APP
+#define LOG_LEVEL_APP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_WEATHER
+#define LOG_LEVEL_WEATHER LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_ROUTER
+#define LOG_LEVEL_ROUTER LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_BUS
+#define LOG_LEVEL_BUS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_FONTS
+#define LOG_LEVEL_FONTS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MEM
+#define LOG_LEVEL_MEM LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_TICK
+#define LOG_LEVEL_TICK LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_COUNTERS
+#define LOG_LEVEL_COUNTERS LOG_LEVEL_DEFAULT
+#endif
+
+#ifndef LOG_MODULE_LEVEL
+#error "define LOG_MODULE_LEVEL before including log.h"
+#endif
+
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 0
+#endif
+
+/* True when the including module logs at `level`, for code that only
+ * exists to feed a log line: #if LOG_ENABLED(LOG_LEVEL_INFO) ... #endif
+ */
+#define LOG_ENABLED(level) (LOG_MODULE_LEVEL >= (level))
+
+/* Characters kept of each ring record's formatted text. */
+#define LOG_RING_TEXT 64
+
+#if LOG_RING_SIZE > 0
+void log_ring_write(AppLogLevel level, const char *fmt, ...);
+#define LOG_EMIT(level, ...) log_ring_write((level), __VA_ARGS__)
+#else
+#define LOG_EMIT(level, ...) APP_LOG((level), __VA_ARGS__)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_EMIT(APP_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_EMIT(APP_LOG_LEVEL_WARNING, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_EMIT(APP_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_EMIT(APP_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+/* Write the ring's records, oldest first, to the log channel and empty it.
+ * Does nothing without LOG_RING_SIZE.
+ */
+void log_dump(void);
@@ -0,0 +1,72 @@
+#include "mem_stats.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_MEM
+#include "log.h"
+#include "message_keys.auto.h"
+
+#ifndef MESSAGE_KEY_MEMORY_REPORT
+#define MESSAGE_KEY_MEMORY_REPORT 10019
+#endif
+
+static mem_checkpoint_stats_t s_checkpoints[MEM_CHECKPOINT_COUNT];
+static uintptr_t s_stack_base = 0;
+
+static const char *const s_checkpoint_names[MEM_CHECKPOINT_COUNT] = {
+  "init", "window_load", "font_load", "weather_update",
+};
+
+void mem_stats_init(const void *stack_base) {
+  s_stack_base = (uintptr_t)stack_base;
+  memset(s_checkpoints, 0, sizeof(s_checkpoints));
+}
+
+void mem_stats_sample(mem_checkpoint_t checkpoint) {
+  char marker;
+  mem_checkpoint_stats_t *cp = &s_checkpoints[checkpoint];
+  cp->heap_used = heap_bytes_used();
+  cp->heap_free = heap_bytes_free();
+  if (cp->heap_used > cp->heap_used_max) cp->heap_used_max = cp->heap_used;
+  if (!cp->samples || cp->heap_free < cp->heap_free_min) cp->heap_free_min = cp->heap_free;
+  uintptr_t here = (uintptr_t)&marker;
+  uint32_t depth = (s_stack_base > here) ? (uint32_t)(s_stack_base - here) : 0;
+  if (depth > cp->stack_max) cp->stack_max = (uint16_t)depth;
+  if (cp->samples < UINT16_MAX) cp->samples++;
+}
+
+const mem_checkpoint_stats_t *mem_stats_get(mem_checkpoint_t checkpoint) {
+  return &s_checkpoints[checkpoint];
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = (v >> 24) & 0xFF;
+  return p + 4;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  return p + 2;
+}
+
+void mem_stats_write_report(DictionaryIterator *iter) {
+  uint8_t report[MEM_REPORT_SIZE];
+  uint8_t *p = report;
+  *p++ = MEM_REPORT_VERSION;
+  *p++ = MEM_CHECKPOINT_COUNT;
+  for (int i = 0; i < MEM_CHECKPOINT_COUNT; ++i) {
+    const mem_checkpoint_stats_t *cp = &s_checkpoints[i];
+    LOG_INFO("mem %s: used=%lu free=%lu used_max=%lu free_min=%lu stack_max=%u samples=%u",
+            s_checkpoint_names[i], (unsigned long)cp->heap_used, (unsigned long)cp->heap_free,
+            (unsigned long)cp->heap_used_max, (unsigned long)cp->heap_free_min,
+            (unsigned)cp->stack_max, (unsigned)cp->samples);
+    p = put_u32(p, cp->heap_used);
+    p = put_u32(p, cp->heap_free);
+    p = put_u32(p, cp->heap_used_max);
+    p = put_u32(p, cp->heap_free_min);
+    p = put_u16(p, cp->stack_max);
+    p = put_u16(p, cp->samples);
+  }
+  dict_write_data(iter, MESSAGE_KEY_MEMORY_REPORT, report, sizeof(report));
+}
@@ -0,0 +1,57 @@
+/* mem_stats.h
+ * Heap and stack usage at fixed checkpoints, with high-water marks.
+ *
+ * Each checkpoint stands for one phase of the face (app init, window load,
+ * custom font loads, weather updates). Sampling reads heap_bytes_used() and
+ * heap_bytes_free() and the current stack depth below main(); the figures
+ * can be sent to the companion as one MEMORY_REPORT byte array so memory
+ * budgets can be tracked per platform.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+typedef enum {
+  MEM_CHECKPOINT_INIT,           /* end of app init */
+  MEM_CHECKPOINT_WINDOW_LOAD,    /* end of window load (all layers created) */
+  MEM_CHECKPOINT_FONT_LOAD,      /* after each custom font load */
+  MEM_CHECKPOINT_WEATHER_UPDATE, /* after each weather update is drawn */
+  MEM_CHECKPOINT_COUNT
+} mem_checkpoint_t;
+
+typedef struct {
+  uint32_t heap_used;     /* at the last sample */
+  uint32_t heap_free;
+  uint32_t heap_used_max; /* high-water mark across samples */
+  uint32_t heap_free_min;
+  uint16_t stack_max;     /* deepest stack seen, bytes below main() */
+  uint16_t samples;
+} mem_checkpoint_stats_t;
+
+/* MEMORY_REPORT byte array, little-endian:
+ *   [0]      version (MEM_REPORT_VERSION)
+ *   [1]      checkpoint count N
+ *   [2..]    N x 20 bytes in mem_checkpoint_t order: uint32 heap_used,
+ *            heap_free, heap_used_max, heap_free_min, uint16 stack_max,
+ *            samples
+ */
+#define MEM_REPORT_VERSION 1
+#define MEM_REPORT_ENTRY_SIZE 20
+#define MEM_REPORT_SIZE (2 + MEM_CHECKPOINT_COUNT * MEM_REPORT_ENTRY_SIZE)
+
+/* Reset all checkpoints. `stack_base` is the address of a local in main(),
+ * which stack depths are measured from. Call first thing in main().
+ */
+void mem_stats_init(const void *stack_base);
+
+/* Record heap and stack usage at a checkpoint. */
+void mem_stats_sample(mem_checkpoint_t checkpoint);
+
+/* Figures of one checkpoint; owned by the module. */
+const mem_checkpoint_stats_t *mem_stats_get(mem_checkpoint_t checkpoint);
+
+/* Add every checkpoint as a MEMORY_REPORT byte array to an outgoing
+ * message for the companion.
+ */
+void mem_stats_write_report(DictionaryIterator *iter);
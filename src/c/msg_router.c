@@ -0,0 +1,100 @@
+#include "msg_router.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_ROUTER
+#include "log.h"
+#include "event_bus.h"
+
+typedef struct {
+  uint32_t first;
+  uint32_t last;
+  msg_router_tuple_handler handler;
+  msg_router_done_handler done;
+  void *ctx;
+} msg_route_t;
+
+/* Internal state */
+static msg_route_t s_routes[MSG_ROUTER_MAX_ROUTES]; /* sorted by first key */
+static int s_route_count = 0;
+static int s_bus_handle = -1;
+
+/* Index of the route owning `key`, or -1. */
+static int find_route(uint32_t key) {
+  int lo = 0, hi = s_route_count - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (key < s_routes[mid].first) {
+      hi = mid - 1;
+    } else if (key > s_routes[mid].last) {
+      lo = mid + 1;
+    } else {
+      return mid;
+    }
+  }
+  return -1;
+}
+
+static void router_inbox_handler(DictionaryIterator *iter, void *ctx) {
+  bool hit[MSG_ROUTER_MAX_ROUTES] = { false };
+  for (Tuple *t = dict_read_first(iter); t; t = dict_read_next(iter)) {
+    int i = find_route(t->key);
+    if (t->type == TUPLE_CSTRING) {
+      LOG_DEBUG("inbox key=%lu%s string=%s", (unsigned long)t->key, i >= 0 ? "" : " (unrouted)", t->value->cstring);
+    } else {
+      LOG_DEBUG("inbox key=%lu%s type=%d int=%ld", (unsigned long)t->key, i >= 0 ? "" : " (unrouted)", (int)t->type, (long)t->value->int32);
+    }
+    if (i < 0) continue;
+    s_routes[i].handler(t, s_routes[i].ctx);
+    hit[i] = true;
+  }
+  /* One done call per owner, however many of its ranges were hit */
+  for (int i = 0; i < s_route_count; ++i) {
+    if (!hit[i] || !s_routes[i].done) continue;
+    bool called = false;
+    for (int j = 0; j < i && !called; ++j) {
+      called = hit[j] && s_routes[j].done == s_routes[i].done && s_routes[j].ctx == s_routes[i].ctx;
+    }
+    if (!called) s_routes[i].done(s_routes[i].ctx);
+  }
+}
+
+void msg_router_init(void) {
+  memset(s_routes, 0, sizeof(s_routes));
+  s_route_count = 0;
+  s_bus_handle = event_bus_subscribe(&(event_bus_listener_t) {
+    .inbox = router_inbox_handler,
+  });
+  if (s_bus_handle < 0) LOG_ERROR("msg_router: no event bus slot; inbox will not be routed");
+}
+
+void msg_router_deinit(void) {
+  event_bus_unsubscribe(s_bus_handle);
+  s_bus_handle = -1;
+  s_route_count = 0;
+}
+
+bool msg_router_register(uint32_t first, uint32_t last, msg_router_tuple_handler handler,
+                         msg_router_done_handler done, void *ctx) {
+  if (!handler || first > last) return false;
+  if (s_route_count >= MSG_ROUTER_MAX_ROUTES) {
+    LOG_ERROR("msg_router: no free route");
+    return false;
+  }
+  /* Insertion point keeping the table sorted; reject overlaps with either
+     neighbour */
+  int pos = 0;
+  while (pos < s_route_count && s_routes[pos].first < first) pos++;
+  if ((pos > 0 && s_routes[pos - 1].last >= first) ||
+      (pos < s_route_count && s_routes[pos].first <= last)) {
+    LOG_ERROR("msg_router: keys %lu-%lu already routed", (unsigned long)first, (unsigned long)last);
+    return false;
+  }
+  memmove(&s_routes[pos + 1], &s_routes[pos], (s_route_count - pos) * sizeof(s_routes[0]));
+  s_routes[pos] = (msg_route_t) {
+    .first = first,
+    .last = last,
+    .handler = handler,
+    .done = done,
+    .ctx = ctx,
+  };
+  s_route_count++;
+  return true;
+}
@@ -0,0 +1,48 @@
+/* msg_router.h
+ * Dispatch of incoming AppMessage tuples to the modules that own their keys.
+ *
+ * Modules register the key ranges they own at init. For each inbox message
+ * the router walks the dictionary once and hands every tuple to the owner
+ * of its key, found by binary search in a table of ranges sorted by key.
+ * Owners that need the whole message (e.g. to apply several keys together)
+ * collect tuples in their tuple handler and act in their done handler,
+ * which runs once per message after the pass if any of their keys arrived.
+ *
+ * Message keys are numbered in the order of messageKeys in package.json,
+ * so a range of MESSAGE_KEY_* values stays valid only while those keys stay
+ * adjacent there.
+ *
+ * At LOG_LEVEL_DEBUG for the router (see log.h) every tuple is logged,
+ * flagging keys nobody owns.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+/* Maximum number of registered key ranges. */
+#define MSG_ROUTER_MAX_ROUTES 8
+
+/* Called for each tuple whose key is in the range. The tuple is only valid
+ * until the message's done handlers have run.
+ */
+typedef void (*msg_router_tuple_handler)(const Tuple *t, void *ctx);
+
+/* Called once after the pass for owners that received at least one tuple. */
+typedef void (*msg_router_done_handler)(void *ctx);
+
+/* Reset the table and start receiving inbox messages from the event bus
+ * (which must be initialized first).
+ */
+void msg_router_init(void);
+
+/* Drop all routes and leave the event bus. */
+void msg_router_deinit(void);
+
+/* Route keys `first`..`last` (inclusive) to `handler`. `done` may be NULL;
+ * ranges registered with the same `done` and `ctx` share one done call per
+ * message. Returns false if the table is full or the range overlaps one
+ * already registered.
+ */
+bool msg_router_register(uint32_t first, uint32_t last, msg_router_tuple_handler handler,
+                         msg_router_done_handler done, void *ctx);
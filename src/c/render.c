@@ -0,0 +1,153 @@
+#include "render.h"
+#include "counters.h"
+
+#if RENDER_CANVAS
+
+/* Everything the update proc needs to draw one slot. */
+typedef struct {
+  GRect frame;
+  GFont font;        /* NULL until the slot is added */
+  const char *text;
+  uint8_t alignment; /* GTextAlignment */
+  uint8_t overflow;  /* GTextOverflowMode */
+  bool hidden;
+} render_slot_state_t;
+
+static Layer *s_canvas = NULL;
+static render_slot_state_t s_slots[RENDER_SLOT_COUNT];
+static GColor s_color;
+
+static void canvas_update_proc(Layer *layer, GContext *ctx) {
+  graphics_context_set_text_color(ctx, s_color);
+  for (int i = 0; i < RENDER_SLOT_COUNT; ++i) {
+    const render_slot_state_t *slot = &s_slots[i];
+    if (!slot->font || slot->hidden || !slot->text || !slot->text[0]) continue;
+    graphics_draw_text(ctx, slot->text, slot->font, slot->frame,
+                       (GTextOverflowMode)slot->overflow, (GTextAlignment)slot->alignment, NULL);
+  }
+}
+
+void render_init(Layer *parent, GColor color) {
+  memset(s_slots, 0, sizeof(s_slots));
+  s_color = color;
+  s_canvas = layer_create(layer_get_bounds(parent));
+  layer_set_update_proc(s_canvas, canvas_update_proc);
+  layer_add_child(parent, s_canvas);
+}
+
+void render_deinit(void) {
+  if (s_canvas) layer_destroy(s_canvas);
+  s_canvas = NULL;
+}
+
+void render_add_slot(render_slot_t slot, GRect frame, GFont font, GTextAlignment alignment) {
+  s_slots[slot] = (render_slot_state_t) {
+    .frame = frame,
+    .font = font,
+    .alignment = alignment,
+    .overflow = GTextOverflowModeWordWrap,
+  };
+  layer_mark_dirty(s_canvas);
+}
+
+/* Setters only invalidate the canvas when the slot's drawing changes. Text is
+   the exception: the caller rewrites its buffer in place, so a call always
+   means new content. */
+void render_set_text(render_slot_t slot, const char *text) {
+  s_slots[slot].text = text;
+  if (s_slots[slot].hidden) return;
+  counters_inc(COUNTER_REDRAWS + slot);
+  layer_mark_dirty(s_canvas);
+}
+
+void render_set_hidden(render_slot_t slot, bool hidden) {
+  if (s_slots[slot].hidden == hidden) return;
+  s_slots[slot].hidden = hidden;
+  counters_inc(COUNTER_REDRAWS + slot);
+  layer_mark_dirty(s_canvas);
+}
+
+void render_set_frame(render_slot_t slot, GRect frame) {
+  if (grect_equal(&s_slots[slot].frame, &frame)) return;
+  s_slots[slot].frame = frame;
+  counters_inc(COUNTER_REDRAWS + slot);
+  layer_mark_dirty(s_canvas);
+}
+
+void render_set_overflow_mode(render_slot_t slot, GTextOverflowMode mode) {
+  if (s_slots[slot].overflow == mode) return;
+  s_slots[slot].overflow = mode;
+  layer_mark_dirty(s_canvas);
+}
+
+void render_set_text_color(GColor color) {
+  if (gcolor_equal(s_color, color)) return;
+  s_color = color;
+  layer_mark_dirty(s_canvas);
+}
+
+#else /* TextLayer backend */
+
+static Layer *s_parent = NULL;
+static TextLayer *s_layers[RENDER_SLOT_COUNT];
+static GColor s_color;
+
+void render_init(Layer *parent, GColor color) {
+  memset(s_layers, 0, sizeof(s_layers));
+  s_parent = parent;
+  s_color = color;
+}
+
+void render_deinit(void) {
+  for (int i = 0; i < RENDER_SLOT_COUNT; ++i) {
+    if (s_layers[i]) text_layer_destroy(s_layers[i]);
+    s_layers[i] = NULL;
+  }
+  s_parent = NULL;
+}
+
+void render_add_slot(render_slot_t slot, GRect frame, GFont font, GTextAlignment alignment) {
+  TextLayer *layer = text_layer_create(frame);
+  text_layer_set_background_color(layer, GColorClear);
+  text_layer_set_text_color(layer, s_color);
+  text_layer_set_font(layer, font);
+  text_layer_set_text_alignment(layer, alignment);
+  layer_add_child(s_parent, text_layer_get_layer(layer));
+  s_layers[slot] = layer;
+}
+
+/* Redraws are counted as in the canvas backend: only calls that change what
+   is drawn. */
+void render_set_text(render_slot_t slot, const char *text) {
+  text_layer_set_text(s_layers[slot], text);
+  if (layer_get_hidden(text_layer_get_layer(s_layers[slot]))) return;
+  counters_inc(COUNTER_REDRAWS + slot);
+}
+
+void render_set_hidden(render_slot_t slot, bool hidden) {
+  Layer *layer = text_layer_get_layer(s_layers[slot]);
+  if (layer_get_hidden(layer) == hidden) return;
+  counters_inc(COUNTER_REDRAWS + slot);
+  layer_set_hidden(layer, hidden);
+}
+
+void render_set_frame(render_slot_t slot, GRect frame) {
+  Layer *layer = text_layer_get_layer(s_layers[slot]);
+  GRect current = layer_get_frame(layer);
+  if (grect_equal(&current, &frame)) return;
+  counters_inc(COUNTER_REDRAWS + slot);
+  layer_set_frame(layer, frame);
+}
+
+void render_set_overflow_mode(render_slot_t slot, GTextOverflowMode mode) {
+  text_layer_set_overflow_mode(s_layers[slot], mode);
+}
+
+void render_set_text_color(GColor color) {
+  s_color = color;
+  for (int i = 0; i < RENDER_SLOT_COUNT; ++i) {
+    if (s_layers[i]) text_layer_set_text_color(s_layers[i], color);
+  }
+}
+
+#endif
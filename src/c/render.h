@@ -0,0 +1,45 @@
+/* render.h
+ * Draws the face's text complications ("slots").
+ *
+ * Two backends share this API, chosen at build time with RENDER_CANVAS
+ * (see the --canvas option in wscript):
+ *  - 0 (default): one TextLayer per slot, as the face always used.
+ *  - 1: a single Layer whose update proc draws every visible slot with
+ *    graphics_draw_text() from a compact state table. This saves a TextLayer
+ *    allocation and layer-tree node per slot, which matters on aplite.
+ * Callers set frames, fonts and text the same way for both, so heap use and
+ * frame time can be compared by rebuilding with the other backend.
+ */
+
+#pragma once
+
+#include <pebble.h>
+#include "render_slots.h"
+
+#ifndef RENDER_CANVAS
+#define RENDER_CANVAS 0
+#endif
+
+/* Create the backend's layers as children of `parent`, with every slot
+ * drawn in `color`. Slots stay empty until render_add_slot().
+ */
+void render_init(Layer *parent, GColor color);
+
+/* Destroy all layers created by render_init()/render_add_slot(). */
+void render_deinit(void);
+
+/* Place a slot. Slots start visible, empty and word-wrapped. */
+void render_add_slot(render_slot_t slot, GRect frame, GFont font, GTextAlignment alignment);
+
+/* Show `text` in a slot. As with text_layer_set_text() only the pointer is
+ * kept, so the buffer must outlive the slot; call again after rewriting the
+ * buffer so the slot is redrawn.
+ */
+void render_set_text(render_slot_t slot, const char *text);
+
+void render_set_hidden(render_slot_t slot, bool hidden);
+void render_set_frame(render_slot_t slot, GRect frame);
+void render_set_overflow_mode(render_slot_t slot, GTextOverflowMode mode);
+
+/* Text color of every slot (dark mode switches it). */
+void render_set_text_color(GColor color);
@@ -0,0 +1,24 @@
+/* render_slots.h
+ * The face's text complications ("slots"), in drawing order.
+ *
+ * Kept apart from render.h so modules that only count or index slots (the
+ * per-slot redraw counters, see counters.h) do not depend on the renderer.
+ */
+
+#pragma once
+
+/* Slots, drawn in this order. */
+typedef enum {
+  RENDER_TIME,
+  RENDER_DATE,
+  RENDER_ICON_GLYPH,
+  RENDER_ICON_TEST,
+  RENDER_SKY_GLYPH,
+  RENDER_TEMPERATURE,
+  RENDER_HUMIDITY,
+  RENDER_MINMAX,
+  RENDER_SUNRISE,
+  RENDER_SUNSET,
+  RENDER_STATUS,
+  RENDER_SLOT_COUNT
+} render_slot_t;
@@ -0,0 +1,96 @@
+#include "solar.h"
+
+/* The sunrise equation (NOAA's simplified form). Angles are Pebble trig
+   angles (TRIG_MAX_ANGLE per turn), sines and cosines are ratios scaled by
+   TRIG_MAX_RATIO, times are seconds and constants are written in 1e-4
+   degrees. Intermediate products need 64 bits. */
+
+#define DEG_E4_TO_ANGLE(d) ((int32_t)(((int64_t)(d) * TRIG_MAX_ANGLE) / 3600000))
+#define RATIO ((int64_t)TRIG_MAX_RATIO)
+
+/* 1970-01-01 to 2000-01-01; J2000 is noon UTC of that day. */
+#define DAYS_TO_J2000 10957
+#define SECONDS_PER_DAY 86400
+
+/* Mean anomaly at J2000 and its daily motion, in 1e-8 degrees. */
+#define MEAN_ANOMALY_J2000_E8 35752910000LL
+#define MEAN_ANOMALY_RATE_E8 98560028LL
+#define FULL_TURN_E8 36000000000LL
+
+#define ECLIPTIC_OFFSET_E4 2829372  /* 180 + argument of perihelion (102.9372) */
+#define AXIAL_TILT_E4 234400        /* 23.44 */
+#define HORIZON_DIP_E4 8330         /* 0.833 below: refraction plus solar radius */
+
+static int64_t isqrt(int64_t v) {
+  if (v <= 0) return 0;
+  uint64_t x = (uint64_t)v;
+  uint64_t result = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= result + bit) {
+      x -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (int64_t)result;
+}
+
+int32_t solar_days_from_civil(int year, int month, int day) {
+  /* Howard Hinnant's days_from_civil: eras of 400 years from March 1st */
+  year -= month <= 2;
+  int era = (year >= 0 ? year : year - 399) / 400;
+  int yoe = year - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+bool solar_compute(int32_t lat_e4, int32_t lon_e4, int32_t day, solar_times_t *out) {
+  out->sunrise = out->sunset = 0;
+
+  /* Mean solar noon as seconds after UTC midnight, and after J2000 */
+  int32_t noon = SECONDS_PER_DAY / 2 - lon_e4 * 3 / 125; /* lon / 360 of a day */
+  int64_t since_j2000 = (int64_t)(day - DAYS_TO_J2000) * SECONDS_PER_DAY + noon - SECONDS_PER_DAY / 2;
+
+  int64_t anomaly_e8 = (MEAN_ANOMALY_J2000_E8 + MEAN_ANOMALY_RATE_E8 * since_j2000 / SECONDS_PER_DAY) % FULL_TURN_E8;
+  if (anomaly_e8 < 0) anomaly_e8 += FULL_TURN_E8;
+  int32_t m = (int32_t)(anomaly_e8 * TRIG_MAX_ANGLE / FULL_TURN_E8);
+  int32_t sin_m = sin_lookup(m);
+
+  /* Equation of the center, then the sun's ecliptic longitude */
+  int32_t center_e4 = (int32_t)((19148 * (int64_t)sin_m + 200 * (int64_t)sin_lookup(2 * m) +
+                                 3 * (int64_t)sin_lookup(3 * m)) / RATIO);
+  int32_t lambda = (m + DEG_E4_TO_ANGLE(center_e4 + ECLIPTIC_OFFSET_E4)) % TRIG_MAX_ANGLE;
+
+  /* Solar transit: mean noon corrected by the equation of time
+     (0.0053 and 0.0069 of a day) */
+  int64_t transit = noon + (457920 * (int64_t)sin_m - 596160 * (int64_t)sin_lookup(2 * lambda)) / (1000 * RATIO);
+
+  /* Declination */
+  int64_t sin_decl = sin_lookup(lambda) * (int64_t)sin_lookup(DEG_E4_TO_ANGLE(AXIAL_TILT_E4)) / RATIO;
+  int64_t cos_decl = isqrt(RATIO * RATIO - sin_decl * sin_decl);
+
+  /* Hour angle at which the sun's centre crosses the corrected horizon */
+  int32_t lat = DEG_E4_TO_ANGLE(lat_e4);
+  if (lat < 0) lat += TRIG_MAX_ANGLE;
+  int64_t num = -sin_lookup(DEG_E4_TO_ANGLE(HORIZON_DIP_E4)) * RATIO - sin_lookup(lat) * sin_decl;
+  int64_t den = cos_lookup(lat) * cos_decl;
+  if (den <= 0) return false;
+  int64_t cos_w = num * RATIO / den;
+  if (cos_w >= RATIO || cos_w <= -RATIO) return false; /* polar night / day */
+  int64_t sin_w = isqrt(RATIO * RATIO - cos_w * cos_w);
+  /* atan2_lookup takes int16 arguments. Both lie in [-RATIO, RATIO] and
+     sin_w reaches RATIO itself when cos_w is 0, so halving would give
+     32768; a quarter keeps both in range without changing the angle. */
+  int32_t w = atan2_lookup((int16_t)(sin_w >> 2), (int16_t)(cos_w >> 2));
+  int64_t half_day = (int64_t)w * SECONDS_PER_DAY / TRIG_MAX_ANGLE;
+
+  time_t midnight = (time_t)day * SECONDS_PER_DAY;
+  out->sunrise = midnight + (time_t)(transit - half_day);
+  out->sunset = midnight + (time_t)(transit + half_day);
+  return true;
+}
@@ -0,0 +1,30 @@
+/* solar.h
+ * Sunrise/sunset computed on the watch from a location and a date.
+ *
+ * The sun times only move a minute or two per day, so instead of receiving
+ * them with every weather payload the weather module computes them once a
+ * day from the last known coordinates. There is no FPU: everything uses
+ * integer math and the Pebble trig lookups (sin_lookup/atan2_lookup), and
+ * is accurate to about a minute outside the polar circles.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+typedef struct {
+  time_t sunrise; /* UTC epoch, 0 if the sun does not rise that day */
+  time_t sunset;  /* UTC epoch, 0 if the sun does not set that day */
+} solar_times_t;
+
+/* Days since 1970-01-01 of a proleptic Gregorian calendar date
+ * (month 1-12, day 1-31).
+ */
+int32_t solar_days_from_civil(int year, int month, int day);
+
+/* Compute the sunrise and sunset of calendar day `day` (days since
+ * 1970-01-01, see solar_days_from_civil()) at latitude/longitude given in
+ * 1e-4 degrees, north and east positive. Returns false, with both times 0,
+ * during polar day or polar night.
+ */
+bool solar_compute(int32_t lat_e4, int32_t lon_e4, int32_t day, solar_times_t *out);
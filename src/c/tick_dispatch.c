@@ -0,0 +1,98 @@
+#include "tick_dispatch.h"
+#include "counters.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_TICK
+#include "log.h"
+
+typedef struct {
+  tick_dispatch_handler handler;
+  void *ctx;
+  TimeUnits units;
+  uint16_t period;
+} tick_subscriber_t;
+
+/* Internal state */
+static tick_subscriber_t s_subs[TICK_DISPATCH_MAX_SUBSCRIBERS];
+static TimeUnits s_subscribed_unit = 0; /* 0 = not subscribed */
+
+/* Lowest set bit of a TimeUnits mask, i.e. the finest unit it contains. */
+static TimeUnits finest_unit(TimeUnits units) {
+  return (TimeUnits)(units & -units);
+}
+
+/* Position of `tick_time` counted in `unit`, used to align periods to the
+   wall clock (e.g. minutes since midnight for MINUTE_UNIT). */
+static int unit_index(const struct tm *tick_time, TimeUnits unit) {
+  switch (unit) {
+    case SECOND_UNIT: return (tick_time->tm_hour * 60 + tick_time->tm_min) * 60 + tick_time->tm_sec;
+    case MINUTE_UNIT: return tick_time->tm_hour * 60 + tick_time->tm_min;
+    case HOUR_UNIT: return tick_time->tm_hour;
+    case DAY_UNIT: return tick_time->tm_yday;
+    case MONTH_UNIT: return tick_time->tm_mon;
+    default: return tick_time->tm_year;
+  }
+}
+
+static void dispatch_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  counters_inc(COUNTER_TICK_WAKEUPS);
+  for (int i = 0; i < TICK_DISPATCH_MAX_SUBSCRIBERS; ++i) {
+    tick_subscriber_t *sub = &s_subs[i];
+    if (!sub->handler || !(units_changed & sub->units)) continue;
+    if (sub->period > 1 && (unit_index(tick_time, finest_unit(sub->units)) % sub->period) != 0) continue;
+    sub->handler(tick_time, units_changed, sub->ctx);
+  }
+}
+
+/* Keep exactly one service subscription at the finest unit still needed. */
+static void update_subscription(void) {
+  TimeUnits needed = 0;
+  for (int i = 0; i < TICK_DISPATCH_MAX_SUBSCRIBERS; ++i) {
+    if (s_subs[i].handler) needed |= s_subs[i].units;
+  }
+  TimeUnits unit = finest_unit(needed);
+  if (unit == s_subscribed_unit) return;
+  if (unit) {
+    tick_timer_service_subscribe(unit, dispatch_tick_handler);
+  } else {
+    tick_timer_service_unsubscribe();
+  }
+  s_subscribed_unit = unit;
+}
+
+void tick_dispatch_init(void) {
+  memset(s_subs, 0, sizeof(s_subs));
+  s_subscribed_unit = 0;
+}
+
+void tick_dispatch_deinit(void) {
+  memset(s_subs, 0, sizeof(s_subs));
+  update_subscription();
+}
+
+int tick_dispatch_register(TimeUnits units, uint16_t period, tick_dispatch_handler handler, void *ctx) {
+  if (!handler || !units) return -1;
+  for (int i = 0; i < TICK_DISPATCH_MAX_SUBSCRIBERS; ++i) {
+    if (!s_subs[i].handler) {
+      s_subs[i] = (tick_subscriber_t) {
+        .handler = handler,
+        .ctx = ctx,
+        .units = units,
+        .period = period,
+      };
+      update_subscription();
+      return i;
+    }
+  }
+  LOG_ERROR("tick_dispatch: no free subscriber slot");
+  return -1;
+}
+
+void tick_dispatch_set_period(int handle, uint16_t period) {
+  if (handle < 0 || handle >= TICK_DISPATCH_MAX_SUBSCRIBERS) return;
+  s_subs[handle].period = period;
+}
+
+void tick_dispatch_unregister(int handle) {
+  if (handle < 0 || handle >= TICK_DISPATCH_MAX_SUBSCRIBERS) return;
+  memset(&s_subs[handle], 0, sizeof(s_subs[handle]));
+  update_subscription();
+}
@@ -0,0 +1,39 @@
+/* tick_dispatch.h
+ * Single owner of the TickTimerService subscription.
+ *
+ * The Pebble tick service keeps only one handler per app, so modules must
+ * not call tick_timer_service_subscribe() themselves. Instead they register
+ * a callback here with the TimeUnits they care about and a period; the
+ * dispatcher subscribes once at the finest unit any subscriber needs and
+ * only wakes each subscriber when its period is due.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+/* Maximum number of simultaneous subscribers (clock, weather, ...). */
+#define TICK_DISPATCH_MAX_SUBSCRIBERS 6
+
+typedef void (*tick_dispatch_handler)(struct tm *tick_time, TimeUnits units_changed, void *ctx);
+
+/* Reset the registry. Call once before any module registers. */
+void tick_dispatch_init(void);
+
+/* Drop all subscribers and release the tick service subscription. */
+void tick_dispatch_deinit(void);
+
+/* Register a subscriber. `units` is the TimeUnits mask that must have changed
+ * for the subscriber to be considered (e.g. MINUTE_UNIT, DAY_UNIT).
+ * `period` is in multiples of the finest unit in `units` and is aligned to
+ * wall-clock time (period 20 with MINUTE_UNIT fires at :00, :20, :40 past
+ * each hour); 0 or 1 means every tick. Returns a handle >= 0, or -1 when the
+ * registry is full.
+ */
+int tick_dispatch_register(TimeUnits units, uint16_t period, tick_dispatch_handler handler, void *ctx);
+
+/* Change the period of an existing subscriber. */
+void tick_dispatch_set_period(int handle, uint16_t period);
+
+/* Remove a subscriber. Unknown or negative handles are ignored. */
+void tick_dispatch_unregister(int handle);
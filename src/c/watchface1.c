@@ -12,11 +12,21 @@
 // message_keys.auto.h is generated at build time from package.json messageKeys
 #include "message_keys.auto.h"
 #include "weather.h"
+#include "tick_dispatch.h"
+#include "layout.h"
+#include "render.h"
+#include "mem_stats.h"
+#include "counters.h"
+#include "font_registry.h"
+#include "event_bus.h"
+#include "msg_router.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_APP
+#include "log.h"
 
 // If build didn't regenerate message_keys header for DARK_MODE yet, provide a
-// fallback numeric value matching appinfo.json (will be 10009 after package.json change).
+// fallback numeric value matching package.json (index 12, so 10012).
 #ifndef MESSAGE_KEY_DARK_MODE
-#define MESSAGE_KEY_DARK_MODE 10009
+#define MESSAGE_KEY_DARK_MODE 10012
 #endif
 
 // Fallback for SKY_COND (numeric key generated into appinfo.json). If the
@@ -25,37 +35,71 @@
 #define MESSAGE_KEY_SKY_COND 10006
 #endif
 
-// Fallback for CITY message key (numeric mapping). Companion uses 10011.
-#ifndef MESSAGE_KEY_CITY
-#define MESSAGE_KEY_CITY 10011
+#ifndef MESSAGE_KEY_MEMORY_REPORT
+#define MESSAGE_KEY_MEMORY_REPORT 10019
+#endif
+#ifndef MESSAGE_KEY_LOG_DUMP
+#define MESSAGE_KEY_LOG_DUMP 10020
+#endif
+#ifndef MESSAGE_KEY_COUNTERS
+#define MESSAGE_KEY_COUNTERS 10021
 #endif
 
+// Debug reports the companion asked for in the message being routed
+static bool s_memory_report_requested = false;
+static bool s_counters_requested = false;
+
 static void prv_format_and_update_weather(void);
 
 static Window *s_window;
-static TextLayer *s_time_layer, *s_date_layer;
-static TextLayer *s_icon_test_layer;
-static TextLayer *s_icon_glyph_layer; // shows the WeatherIcons glyph next to the icon code
-static TextLayer *s_temperature_layer, *s_humidity_layer, *s_minmax_layer, *s_sunrise_layer, *s_sunset_layer, *s_status_layer;
-static TextLayer *s_sky_glyph_layer;
-static bool s_sky_test_all = false; // when true, draw all three icons for testing
-static GFont s_date_font = NULL;
-static GFont s_time_font = NULL;
-static GFont s_icon_font = NULL;
-static GFont s_sky_font = NULL; // FONT_WEATHER_12 for the small sky glyph
+static bool s_window_loaded = false; // render slots exist (see render.h)
+static GFont s_temp_font = NULL; // font of the temperature slot
+
+// Font role of each complication. Every slot acquires its font on window
+// load and releases it on unload, so a custom font stays loaded exactly as
+// long as something on screen uses it (see font_registry.h).
+static const face_font_t s_slot_fonts[RENDER_SLOT_COUNT] = {
+  [RENDER_TIME]        = FACE_FONT_TIME,
+  [RENDER_DATE]        = FACE_FONT_DATE,
+  [RENDER_ICON_GLYPH]  = FACE_FONT_GLYPH,
+  [RENDER_ICON_TEST]   = FACE_FONT_ICON_CODE,
+  [RENDER_SKY_GLYPH]   = FACE_FONT_GLYPH,
+  [RENDER_TEMPERATURE] = FACE_FONT_TEMPERATURE,
+  [RENDER_HUMIDITY]    = FACE_FONT_METRIC,
+  [RENDER_MINMAX]      = FACE_FONT_METRIC,
+  [RENDER_SUNRISE]     = FACE_FONT_SUN,
+  [RENDER_SUNSET]      = FACE_FONT_SUN,
+  [RENDER_STATUS]      = FACE_FONT_METRIC,
+};
+
+// Geometry the temperature group is centered in. The neighbouring frames are
+// fixed once the window has loaded, so they are captured there instead of
+// being read back from the layers on every update.
+static GRect s_bounds, s_sky_frame, s_hum_frame, s_minmax_frame;
+static GRect s_temp_frame; // frame last applied to the temperature slot
+
+// Measured widths of recently shown strings, per font. Temperatures only
+// span a small range, so a handful of entries avoids nearly every text
+// layout pass; entries are replaced round-robin.
+#define TEXT_WIDTH_CACHE_SIZE 8
+typedef struct {
+  GFont font;
+  int16_t width;
+  char text[12];
+} text_width_entry_t;
+static text_width_entry_t s_width_cache[TEXT_WIDTH_CACHE_SIZE];
+static uint8_t s_width_cache_next = 0;
 
 // State
 static int s_temp = 0;
 static int s_humidity = 0;
 static int s_min = 0;
 static int s_max = 0;
-static time_t s_sunrise = 0;
-static time_t s_sunset = 0;
+static bool s_weather_stale = false;
 static bool s_bt_connected = true;
 static int s_battery_level = 100;
 // Note: weather request cooldown is managed inside the weather module.
-static bool s_prev_bt_connected = true;
-// Per-layer persistent text buffers (TextLayer stores the pointer)
+// Per-slot persistent text buffers (render slots keep only the pointer)
 // static char s_weather_buf[64]; // no longer used; replaced by s_temperature_buffer and s_hum_buf
 static char s_temperature_buffer[32];
 static char s_hum_buf[32];
@@ -67,6 +111,20 @@ static char s_city_buf[32];
 static char s_sky_glyph_buf[8];
 static char s_icon_code_buf[8];
 // s_sky_code removed: glyphs provided by companion/module are used instead
+
+// Per-field invalidation. Each complication owns one bit; callbacks set the
+// bits for values that actually changed and prv_format_and_update_weather()
+// only reformats (and marks dirty) the render slots behind set bits.
+enum {
+  DIRTY_TEMP     = 1 << 0,
+  DIRTY_HUMIDITY = 1 << 1,
+  DIRTY_MINMAX   = 1 << 2,
+  DIRTY_SUN      = 1 << 3,
+  DIRTY_STATUS   = 1 << 4,
+  DIRTY_GLYPH    = 1 << 5,
+  DIRTY_ALL      = 0x3F
+};
+static uint8_t s_dirty = DIRTY_ALL;
 // Dark mode flag (user option to toggle later). true = black background, white text.
 static bool s_dark_mode = true;
 
@@ -100,12 +158,12 @@ static void prv_update_time() {
     strftime(buf, sizeof(buf), "%I:%M", tick_time);
     if (buf[0] == '0') memmove(buf, buf + 1, strlen(buf));
   }
-  text_layer_set_text(s_time_layer, buf);
+  render_set_text(RENDER_TIME, buf);
 
   // Date (ISO 8601)
   static char date_buf[32];
   strftime(date_buf, sizeof(date_buf), "%Y-%m-%d", tick_time);
-  text_layer_set_text(s_date_layer, date_buf);
+  render_set_text(RENDER_DATE, date_buf);
 }
 
 /* Test trigger: Select button runs a sample weather payload */
@@ -120,208 +178,216 @@ static void prv_click_config_provider(void *context) {
 /* Callback from weather module when new data arrives */
 static void weather_module_cb(const weather_data_t *data, void *ctx) {
   if (!data) return;
-  s_temp = data->temp;
-  s_humidity = data->humidity;
-  s_min = data->min;
-  s_max = data->max;
-  s_sunrise = data->sunrise;
-  s_sunset = data->sunset;
+  if (data->temp != s_temp) { s_temp = data->temp; s_dirty |= DIRTY_TEMP; }
+  if (weather_is_stale() != s_weather_stale) { s_weather_stale = !s_weather_stale; s_dirty |= DIRTY_TEMP; }
+  if (data->humidity != s_humidity) { s_humidity = data->humidity; s_dirty |= DIRTY_HUMIDITY; }
+  if (data->min != s_min || data->max != s_max) {
+    s_min = data->min;
+    s_max = data->max;
+    s_dirty |= DIRTY_MINMAX;
+  }
+  // Sun times arrive preformatted ("HH:MM") from the weather module
+  if (strcmp(s_sunrise_buf, data->sunrise_text) != 0 || strcmp(s_sunset_buf, data->sunset_text) != 0) {
+    strncpy(s_sunrise_buf, data->sunrise_text, sizeof(s_sunrise_buf));
+    s_sunrise_buf[sizeof(s_sunrise_buf)-1] = '\0';
+    strncpy(s_sunset_buf, data->sunset_text, sizeof(s_sunset_buf));
+    s_sunset_buf[sizeof(s_sunset_buf)-1] = '\0';
+    s_dirty |= DIRTY_SUN;
+  }
   /* sky_code is no longer used; glyphs are provided by the weather module */
-  strncpy(s_city_buf, data->city, sizeof(s_city_buf));
-  s_city_buf[sizeof(s_city_buf)-1] = '\0';
-  // Copy glyph (may be UTF-8 multi-byte); weather module uses null-terminated
-  if (data->glyph && data->glyph[0]) {
+  if (strncmp(s_city_buf, data->city, sizeof(s_city_buf)) != 0) {
+    strncpy(s_city_buf, data->city, sizeof(s_city_buf));
+    s_city_buf[sizeof(s_city_buf)-1] = '\0';
+    s_dirty |= DIRTY_STATUS;
+  }
+  // Copy glyph (may be UTF-8 multi-byte); weather module uses null-terminated.
+  // Per design: do NOT synthesize or show a fallback glyph here. An empty
+  // glyph buffer lets the UI hide glyphs when none provided.
+  if (strncmp(s_sky_glyph_buf, data->glyph, sizeof(s_sky_glyph_buf)) != 0) {
     strncpy(s_sky_glyph_buf, data->glyph, sizeof(s_sky_glyph_buf));
     s_sky_glyph_buf[sizeof(s_sky_glyph_buf)-1] = '\0';
-  } else {
-    // Per design: do NOT synthesize or show a fallback glyph here. Leave
-    // the glyph buffer empty so the UI can hide glyphs when none provided.
-    s_sky_glyph_buf[0] = '\0';
+    s_dirty |= DIRTY_GLYPH;
   }
   // Copy raw OWM icon code string (like "01d") for display when present
-  if (data->icon_code && data->icon_code[0]) {
+  if (strncmp(s_icon_code_buf, data->icon_code, sizeof(s_icon_code_buf)) != 0) {
     strncpy(s_icon_code_buf, data->icon_code, sizeof(s_icon_code_buf));
     s_icon_code_buf[sizeof(s_icon_code_buf)-1] = '\0';
-  } else {
-    s_icon_code_buf[0] = '\0';
+    s_dirty |= DIRTY_GLYPH;
   }
   prv_format_and_update_weather();
+  mem_stats_sample(MEM_CHECKPOINT_WEATHER_UPDATE);
+}
+
+/* Compute the temperature frame for a measured text width. Pure geometry:
+   depends only on its arguments (no Pebble layer or font calls), so it can
+   be exercised off-device and reused by any render path. */
+static GRect prv_layout_temperature_frame(GRect bounds, GRect sky_frame, GRect hum_frame,
+                                          GRect minmax_frame, GRect temp_frame, int temperature_width) {
+  const int ICON_SIZE = sky_frame.size.w;
+  const int GAP = 4;
+  // Cap to available space to avoid overlapping edges
+  int max_temp_w = bounds.size.w - ICON_SIZE - GAP - 8; // small margin
+  if (temperature_width > max_temp_w) temperature_width = max_temp_w;
+  // Center inside the gap between humidity and min/max, using their actual
+  // frames so this works if their widths change
+  int hum_right = hum_frame.origin.x + hum_frame.size.w;
+  int minmax_left = minmax_frame.origin.x;
+  // Preserve temperature Y (it may be intentionally offset)
+  int temp_y = temp_frame.origin.y;
+  int available_w = minmax_left - hum_right;
+  if (available_w <= 0) {
+    // Not enough space, fallback to screen center. Cap temp width to screen
+    // width minus margins so it doesn't overflow
+    int max_temp_w_screen = bounds.size.w - 16;
+    if (max_temp_w_screen < 0) max_temp_w_screen = 0;
+    if (temperature_width > max_temp_w_screen) temperature_width = max_temp_w_screen;
+    return GRect(bounds.size.w / 2 - temperature_width / 2, temp_y, temperature_width, 20);
+  }
+  // Cap temp width to the available gap
+  if (temperature_width > available_w) temperature_width = available_w;
+  return GRect(hum_right + (available_w - temperature_width) / 2, temp_y, temperature_width, 20);
+}
+
+// Width of `text` in `font` within a box `max_w` wide, memoized. Strings
+// too long for a cache slot are measured every time.
+static int prv_text_width(const char *text, GFont font, int max_w) {
+  for (int i = 0; i < TEXT_WIDTH_CACHE_SIZE; ++i) {
+    text_width_entry_t *e = &s_width_cache[i];
+    if (e->font == font && strcmp(e->text, text) == 0) return e->width;
+  }
+  GSize measured = graphics_text_layout_get_content_size(text, font, GRect(0, 0, max_w, 20), GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft);
+  if (strlen(text) < sizeof(s_width_cache[0].text)) {
+    text_width_entry_t *e = &s_width_cache[s_width_cache_next];
+    s_width_cache_next = (s_width_cache_next + 1) % TEXT_WIDTH_CACHE_SIZE;
+    e->font = font;
+    e->width = measured.w;
+    strcpy(e->text, text);
+  }
+  return measured.w;
+}
+
+// Milliseconds since a time_ms() reading
+static uint32_t prv_ms_since(time_t start_s, uint16_t start_ms) {
+  time_t now_s;
+  uint16_t now_ms = time_ms(&now_s, NULL);
+  return (uint32_t)((now_s - start_s) * 1000 + now_ms - start_ms);
 }
 
 static void prv_format_and_update_weather() {
+  // Nothing to do until the window has created its layers, or when no
+  // complication changed since the last pass.
+  if (!s_window_loaded || !s_dirty) return;
+  counters_inc(COUNTER_UPDATES);
+  time_t start_s;
+  uint16_t start_ms = time_ms(&start_s, NULL);
+  uint8_t dirty = s_dirty;
+  s_dirty = 0;
+
   // Weather line
   // Show compact temperature and humidity near the top-left icon (no labels)
-  
-  snprintf(s_hum_buf, sizeof(s_hum_buf), "%d%%", s_humidity);
-  text_layer_set_text(s_humidity_layer, s_hum_buf);
-  // Humidity is displayed centered at the top; no runtime reposition required.
+  if (dirty & DIRTY_HUMIDITY) {
+    snprintf(s_hum_buf, sizeof(s_hum_buf), "%d%%", s_humidity);
+    render_set_text(RENDER_HUMIDITY, s_hum_buf);
+    // Humidity is displayed centered at the top; no runtime reposition required.
+  }
 
   // Min/Max line
   // Show min/max compactly in upper-right as "min-max°"
-  snprintf(s_minmax_buf, sizeof(s_minmax_buf), "%d-%d°", s_min, s_max);
-  text_layer_set_text(s_minmax_layer, s_minmax_buf);
-
-  snprintf(s_temperature_buffer, sizeof(s_temperature_buffer), "%d°C", s_temp);
-  text_layer_set_text(s_temperature_layer, s_temperature_buffer);
-  // Make the central sky+temp group responsive to text width: measure temp
-  if (s_window && s_temperature_layer) {
-  // Get screen bounds and glyph icon frame
-  GRect bounds = layer_get_bounds(window_get_root_layer(s_window));
-  GRect sky_frame = layer_get_frame(text_layer_get_layer(s_sky_glyph_layer));
-  int ICON_SIZE = sky_frame.size.w;
-    const int GAP = 4;
-    // Measure temp text width using the same font used by the layer
-    GFont temp_font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
-    GSize measured = graphics_text_layout_get_content_size(s_temperature_buffer, temp_font, GRect(0, 0, bounds.size.w, 20), GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft);
-    int temperature_width = measured.w;
-    // Cap to available space to avoid overlapping edges
-    int max_temp_w = bounds.size.w - ICON_SIZE - GAP - 8; // small margin
-    if (temperature_width > max_temp_w) temperature_width = max_temp_w;
-    // Compute centered group left position inside the gap between humidity and min/max
-    // Measure actual frames for humidity and minmax so this works if their widths change
-    GRect hum_frame = layer_get_frame(text_layer_get_layer(s_humidity_layer));
-    GRect minmax_frame = layer_get_frame(text_layer_get_layer(s_minmax_layer));
-    int hum_right = hum_frame.origin.x + hum_frame.size.w;
-    int minmax_left = minmax_frame.origin.x;
-
-    // Combined width: icon + gap + temperature width
-    int combined_w = ICON_SIZE + GAP + temperature_width;
-    // Preserve temperature Y (it may be intentionally offset) and keep sky at top (y=0)
-    GRect temp_frame_before = layer_get_frame(text_layer_get_layer(s_temperature_layer));
-    int temp_y = temp_frame_before.origin.y;
-    const int SKY_Y = 0;
-    // Cap combined width to available space (leave a small gutter)
-    int available_w = minmax_left - hum_right;
-    int gutter = 0;
-    if (available_w <= gutter * 2) {
-      // Not enough space, fallback to screen center using combined_w capped to screen
-      if (combined_w > bounds.size.w - 16) combined_w = bounds.size.w - 16;
-      int center_x = bounds.size.w / 2;
-      int group_left = center_x - (combined_w / 2);
-      // If sky is hidden, center only the temperature in the screen center
-          // Cap temp width to screen width minus margins so it doesn't overflow
-          int max_temp_w_screen = bounds.size.w - 16;
-          if (max_temp_w_screen < 0) max_temp_w_screen = 0;
-          if (temperature_width > max_temp_w_screen) temperature_width = max_temp_w_screen;
-          int temp_x_center = center_x - (temperature_width / 2);
-          layer_set_frame(text_layer_get_layer(s_temperature_layer), GRect(temp_x_center, temp_y, temperature_width, 20));
-    } else {
-      if (combined_w > available_w - gutter) combined_w = available_w - gutter;
-      int group_left = hum_right + (available_w - combined_w) / 2;
-      // If the sky layer is hidden, center only the temperature in the gap
-        // Cap temp width to the available gap (leave room for a small gutter)
-        int max_temp_w_gap = available_w - gutter * 2;
-        if (max_temp_w_gap < 0) max_temp_w_gap = 0;
-        if (temperature_width > max_temp_w_gap) temperature_width = max_temp_w_gap;
-        int temp_x = hum_right + (available_w - temperature_width) / 2;
-        layer_set_frame(text_layer_get_layer(s_temperature_layer), GRect(temp_x, temp_y, temperature_width, 20));
+  if (dirty & DIRTY_MINMAX) {
+    snprintf(s_minmax_buf, sizeof(s_minmax_buf), "%d-%d°", s_min, s_max);
+    render_set_text(RENDER_MINMAX, s_minmax_buf);
+  }
+
+  if (dirty & DIRTY_TEMP) {
+    // A trailing '*' marks a snapshot older than the weather module's stale age
+    snprintf(s_temperature_buffer, sizeof(s_temperature_buffer), s_weather_stale ? "%d°C*" : "%d°C", s_temp);
+    render_set_text(RENDER_TEMPERATURE, s_temperature_buffer);
+    // Make the central sky+temp group responsive to text width: measure temp
+    // (memoized) in the layer's font, then let the pure layout helper place
+    // it between the humidity and min/max frames.
+    int width = prv_text_width(s_temperature_buffer, s_temp_font, s_bounds.size.w);
+    GRect frame = prv_layout_temperature_frame(s_bounds, s_sky_frame, s_hum_frame, s_minmax_frame,
+                                               s_temp_frame, width);
+    if (!grect_equal(&frame, &s_temp_frame)) {
+      s_temp_frame = frame;
+      render_set_frame(RENDER_TEMPERATURE, frame);
     }
-    text_layer_set_overflow_mode(s_temperature_layer, GTextOverflowModeTrailingEllipsis);
   }
 
+  if (dirty & DIRTY_GLYPH) {
     // Always prefer the companion/module-provided glyph. If present, show it
     // and hide the procedural sky layer. If not present, show an empty glyph
     // layer (hidden) and leave the procedural drawing in place as a fallback.
     if (s_sky_glyph_buf[0]) {
-      text_layer_set_text(s_sky_glyph_layer, s_sky_glyph_buf);
-      text_layer_set_text_color(s_sky_glyph_layer, s_dark_mode ? GColorWhite : GColorBlack);
-      layer_set_hidden(text_layer_get_layer(s_sky_glyph_layer), false);
+      render_set_text(RENDER_SKY_GLYPH, s_sky_glyph_buf);
+      render_set_hidden(RENDER_SKY_GLYPH, false);
     } else {
-      // No glyph provided: keep glyph layer hidden and show procedural sky
-      text_layer_set_text(s_sky_glyph_layer, "");
-      // procedural layer removed; nothing else to hide/show
-      layer_set_hidden(text_layer_get_layer(s_sky_glyph_layer), true);
+      // No glyph provided: keep the glyph slot hidden
+      render_set_text(RENDER_SKY_GLYPH, "");
+      render_set_hidden(RENDER_SKY_GLYPH, true);
     }
 
-    // Show the raw OWM icon code in the icon test layer (Roboto) for debugging.
-    // Only show the glyph layer if the companion provided an explicit glyph.
+    // Show the raw OWM icon code in the icon test slot (Roboto) for debugging.
+    // Only show the glyph slot if the companion provided an explicit glyph.
     if (s_icon_code_buf[0]) {
-      text_layer_set_text(s_icon_test_layer, s_icon_code_buf);
-      text_layer_set_text_color(s_icon_test_layer, s_dark_mode ? GColorWhite : GColorBlack);
-      layer_set_hidden(text_layer_get_layer(s_icon_test_layer), false);
+      render_set_text(RENDER_ICON_TEST, s_icon_code_buf);
+      render_set_hidden(RENDER_ICON_TEST, false);
       if (s_sky_glyph_buf[0]) {
-        text_layer_set_text(s_icon_glyph_layer, s_sky_glyph_buf);
-        text_layer_set_text_color(s_icon_glyph_layer, s_dark_mode ? GColorWhite : GColorBlack);
-        layer_set_hidden(text_layer_get_layer(s_icon_glyph_layer), false);
+        render_set_text(RENDER_ICON_GLYPH, s_sky_glyph_buf);
+        render_set_hidden(RENDER_ICON_GLYPH, false);
       } else {
-        layer_set_hidden(text_layer_get_layer(s_icon_glyph_layer), true);
+        render_set_hidden(RENDER_ICON_GLYPH, true);
       }
     } else {
-      layer_set_hidden(text_layer_get_layer(s_icon_test_layer), true);
-      layer_set_hidden(text_layer_get_layer(s_icon_glyph_layer), true);
+      render_set_hidden(RENDER_ICON_TEST, true);
+      render_set_hidden(RENDER_ICON_GLYPH, true);
     }
+  }
 
   // Sunrise/Sunset line - always format placeholders so the layer shows something
-  {
-    char rbuf[16] = "--:--", sbuf[16] = "--:--";
-    struct tm *tm;
-    if (s_sunrise) {
-      tm = localtime(&s_sunrise);
-      if (tm) {
-        strftime(rbuf, sizeof(rbuf), "%H:%M", tm);
-      }
-    }
-    if (s_sunset) {
-      tm = localtime(&s_sunset);
-      if (tm) {
-        strftime(sbuf, sizeof(sbuf), "%H:%M", tm);
-      }
-    }
-  // Use small arrow glyphs for sunrise (↑) and sunset (↓). If target font
-  // doesn't contain these glyphs, they'll fall back to a placeholder.
-  snprintf(s_sunrise_buf, sizeof(s_sunrise_buf), "%s", rbuf);
-  snprintf(s_sunset_buf, sizeof(s_sunset_buf), "%s", sbuf);
-  text_layer_set_text(s_sunrise_layer, s_sunrise_buf);
-  text_layer_set_text(s_sunset_layer, s_sunset_buf);
+  if (dirty & DIRTY_SUN) {
+    render_set_text(RENDER_SUNRISE, s_sunrise_buf[0] ? s_sunrise_buf : "--:--");
+    render_set_text(RENDER_SUNSET, s_sunset_buf[0] ? s_sunset_buf : "--:--");
   }
 
   // Status warnings
-  // Read live BT state to avoid stale values
-  bool live_bt = bluetooth_connection_service_peek();
-  APP_LOG(APP_LOG_LEVEL_INFO, "BT peek=%d s_bt_connected=%d", (int)live_bt, (int)s_bt_connected);
-  if (s_battery_level >= 0 && s_battery_level < 20) {
-    snprintf(s_status_buf, sizeof(s_status_buf), "Battery: %d%%", s_battery_level);
-    text_layer_set_text(s_status_layer, s_status_buf);
-  } else if (!live_bt) {
-    strncpy(s_status_buf, "BT Disconnect", sizeof(s_status_buf));
-    s_status_buf[sizeof(s_status_buf)-1] = '\0';
-    text_layer_set_text(s_status_layer, s_status_buf);
-  } else {
-    // No critical warnings; prefer to show city name if we have it.
-    if (s_city_buf[0]) {
-      text_layer_set_text(s_status_layer, s_city_buf);
+  if (dirty & DIRTY_STATUS) {
+    // The bus's BT state is live: it is updated on every transition
+    bool live_bt = event_bus_bt_connected();
+    char status[sizeof(s_status_buf)];
+    if (s_battery_level >= 0 && s_battery_level < 20) {
+      snprintf(status, sizeof(status), "Battery: %d%%", s_battery_level);
+    } else if (!live_bt) {
+      strncpy(status, "BT Disconnect", sizeof(status));
     } else {
-      text_layer_set_text(s_status_layer, "");
+      // No critical warnings; prefer to show city name if we have it.
+      strncpy(status, s_city_buf, sizeof(status));
+    }
+    status[sizeof(status)-1] = '\0';
+    // Only hand the layer new text when the visible string actually changed
+    if (strcmp(status, s_status_buf) != 0) {
+      strcpy(s_status_buf, status);
+      render_set_text(RENDER_STATUS, s_status_buf);
     }
-    text_layer_set_text_color(s_status_layer, s_dark_mode ? GColorWhite : GColorBlack);
   }
+  counters_add(COUNTER_UPDATE_MS, prv_ms_since(start_s, start_ms));
 }
 
-static void prv_inbox_received(DictionaryIterator *iter, void *context) {
-  // Debug: log all tuples received so we can see keys/types/values
-  Tuple *tt = dict_read_first(iter);
-  while (tt) {
-    if (tt->type == TUPLE_CSTRING) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "INBOX TUPLE key=%lu type=STRING val=%s", (unsigned long)tt->key, tt->value->cstring);
-    } else {
-      APP_LOG(APP_LOG_LEVEL_INFO, "INBOX TUPLE key=%lu type=%d int=%ld", (unsigned long)tt->key, (int)tt->type, (long)tt->value->int32);
+// The app's own keys (settings, companion-reported status, debug requests),
+// routed here by msg_router; weather keys go to the weather module
+static void prv_inbox_tuple(const Tuple *t, void *context) {
+  if (t->key == MESSAGE_KEY_BT_CONNECTED) {
+    if ((bool)t->value->int32 != s_bt_connected) {
+      s_bt_connected = (bool)t->value->int32;
+      s_dirty |= DIRTY_STATUS;
     }
-    tt = dict_read_next(iter);
-  }
-
-  // Let weather module parse weather-related keys and notify via callback
-  weather_handle_inbox(iter);
-
-  // Non-weather keys handled here
-  Tuple *t;
-  t = dict_find(iter, MESSAGE_KEY_BT_CONNECTED);
-  if (t) s_bt_connected = (bool)t->value->int32;
-  t = dict_find(iter, MESSAGE_KEY_BATTERY_LEVEL);
-  if (t) s_battery_level = (int)t->value->int32;
-
-  // DARK_MODE may come as an int or string; if present, persist and apply
-  t = dict_find(iter, MESSAGE_KEY_DARK_MODE);
-  if (t) {
+  } else if (t->key == MESSAGE_KEY_BATTERY_LEVEL) {
+    if ((int)t->value->int32 != s_battery_level) {
+      s_battery_level = (int)t->value->int32;
+      s_dirty |= DIRTY_STATUS;
+    }
+  } else if (t->key == MESSAGE_KEY_DARK_MODE) {
+    // DARK_MODE may come as an int or string; persist and apply
     int dm = 0;
     if (t->type == TUPLE_CSTRING && t->value && t->value->cstring) {
       dm = atoi(t->value->cstring);
@@ -331,32 +397,43 @@ static void prv_inbox_received(DictionaryIterator *iter, void *context) {
     prv_set_dark_mode(dm ? true : false);
     // Persist the choice so it survives restarts
     persist_write_int(PERSIST_KEY_DARK_MODE, dm);
-    APP_LOG(APP_LOG_LEVEL_INFO, "DARK_MODE set to %d", dm);
+    LOG_INFO("DARK_MODE set to %d", dm);
+  } else if (t->key == MESSAGE_KEY_MEMORY_REPORT) {
+    // Debug: the companion asks for the memory figures by sending the key
+    s_memory_report_requested = true;
+  } else if (t->key == MESSAGE_KEY_LOG_DUMP) {
+    // Debug: write out the log ring (builds with --log-ring, see log.h)
+    log_dump();
+  } else if (t->key == MESSAGE_KEY_COUNTERS) {
+    s_counters_requested = true;
   }
 }
 
-static void prv_inbox_dropped(AppMessageResult reason, void *context) {
-  APP_LOG(APP_LOG_LEVEL_ERROR, "AppMessage dropped: %d", (int)reason);
-}
-
-static void prv_outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
-  APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d", (int)reason);
-}
-
-static void prv_outbox_sent(DictionaryIterator *iter, void *context) {
-  APP_LOG(APP_LOG_LEVEL_INFO, "Outbox sent");
+// After the pass: answer every requested debug report in one message, as
+// the outbox only holds one at a time
+static void prv_inbox_done(void *context) {
+  if (!s_memory_report_requested && !s_counters_requested) return;
+  DictionaryIterator *iter;
+  AppMessageResult res = app_message_outbox_begin(&iter);
+  if (res == APP_MSG_OK) {
+    if (s_memory_report_requested) mem_stats_write_report(iter);
+    if (s_counters_requested) counters_write_report(iter);
+    dict_write_end(iter);
+    res = app_message_outbox_send();
+  }
+  if (res != APP_MSG_OK) LOG_WARN("Debug report send failed: %d", (int)res);
+  s_memory_report_requested = s_counters_requested = false;
 }
 
-static void prv_bluetooth_callback(bool connected) {
-  // Only trigger on transition disconnected -> connected
-  bool was_connected = s_prev_bt_connected;
-  s_prev_bt_connected = connected;
+static void prv_bluetooth_callback(bool connected, void *context) {
+  // The bus only reports real transitions
   s_bt_connected = connected;
+  s_dirty |= DIRTY_STATUS;
   prv_format_and_update_weather();
-  if (!was_connected && connected) {
+  if (connected) {
     // Delegate to weather module which will enforce its own cooldown.
     if (!weather_request()) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "weather_request() skipped due to cooldown inside module");
+      LOG_INFO("weather_request() skipped due to cooldown inside module");
     }
   }
 }
@@ -364,28 +441,45 @@ static void prv_bluetooth_callback(bool connected) {
 /* prv_request_weather removed: use weather_request() or weather_force_request() from the
    weather module which enforces cooldown internally. */
 
-static void prv_battery_callback(BatteryChargeState state) {
+static void prv_battery_callback(BatteryChargeState state, void *context) {
+  // Battery ticks are frequent; only the status line depends on the level.
+  if (state.charge_percent == s_battery_level) return;
   s_battery_level = state.charge_percent;
+  s_dirty |= DIRTY_STATUS;
   prv_format_and_update_weather();
 }
 
 // Draw a small filled icon for the sky condition in the top-left.
 // Procedural sky icons removed. Glyphs (from companion/module) are used.
 
-static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx) {
   prv_update_time();
-  // Every 30 minutes, request weather refresh
-  if ((tick_time->tm_min % 20) == 0) {
-    // Delegate to weather module which enforces cooldown
-    if (!weather_request()) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "weather_request() skipped due to cooldown inside module (tick)");
-    }
+  // Snapshots age without any message arriving; re-check staleness
+  if (weather_is_stale() != s_weather_stale) {
+    s_weather_stale = !s_weather_stale;
+    s_dirty |= DIRTY_TEMP;
+    prv_format_and_update_weather();
   }
+  // Weather polling is driven by the weather module's own dispatcher
+  // subscription (see weather_start_periodic).
+}
+
+// At midnight, save the counters (including the weather module's radio
+// cost, see counters.h).
+static void prv_day_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx) {
+  counters_persist();
+}
+
+// Create a render slot in its complication's font
+static void prv_add_slot(render_slot_t slot, GRect frame, GTextAlignment alignment) {
+  render_add_slot(slot, frame, font_registry_acquire(s_slot_fonts[slot]), alignment);
 }
 
 static void prv_window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
+  // Frames come from this platform's precomputed table (layout.c)
+  const face_layout_t *layout = layout_get();
 
   // Make the watchface background black
   if (s_dark_mode) {
@@ -394,207 +488,66 @@ static void prv_window_load(Window *window) {
     window_set_background_color(window, GColorWhite);
   }
 
-  // Positioning: center the main time on screen (vertically centered)
-  const int TIME_H = 60;
-  int time_y = (bounds.size.h - TIME_H) / 2;
-  s_time_layer = text_layer_create(GRect(0, time_y, bounds.size.w, TIME_H));
-  text_layer_set_background_color(s_time_layer, GColorClear);
-  text_layer_set_text_color(s_time_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  // Try to load a custom time font (Prototype 48) if present
-  #ifdef RESOURCE_ID_FONT_PROTOTYPE_48
-    s_time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_LECO_47));
-  #endif
-  if (s_time_font) {
-    text_layer_set_font(s_time_layer, s_time_font);
-  } else {
-    text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_ROBOTO_BOLD_SUBSET_49));
-  }
-  // Center the time horizontally
-  text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
-
-  // Icon test layer directly underneath the time so we can preview glyphs
-  // from the weather icon font. Shows the first four glyphs from the
-  // package.json characterRegex so you can see how they render.
-  #ifdef RESOURCE_ID_FONT_WEATHER_24
-    s_icon_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_WEATHER_24));
-  #endif
-  #ifdef RESOURCE_ID_FONT_WEATHER_12
-    s_sky_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_WEATHER_12));
-  #endif
-  const int ICON_TEST_H = 28;
-  int icon_test_y = time_y + TIME_H + 2;
-  // Glyph layer (small square) sits left of the icon code text. Use 20px width
-  // so it displays a single glyph clearly. It will be hidden unless a glyph
-  // is provided by the companion/module.
-  s_icon_glyph_layer = text_layer_create(GRect(6, icon_test_y + 2, 20, ICON_TEST_H - 4));
-  text_layer_set_background_color(s_icon_glyph_layer, GColorClear);
-  text_layer_set_text_color(s_icon_glyph_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_sky_font) text_layer_set_font(s_icon_glyph_layer, s_sky_font);
-  else if (s_icon_font) text_layer_set_font(s_icon_glyph_layer, s_icon_font);
-  else text_layer_set_font(s_icon_glyph_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_text_alignment(s_icon_glyph_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_icon_glyph_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_icon_glyph_layer));
-
-  s_icon_test_layer = text_layer_create(GRect(32, icon_test_y, bounds.size.w - 32, ICON_TEST_H));
-  text_layer_set_background_color(s_icon_test_layer, GColorClear);
-  text_layer_set_text_color(s_icon_test_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  // Use a readable Roboto variant for the raw icon code display
-  text_layer_set_font(s_icon_test_layer, fonts_get_system_font(FONT_KEY_ROBOTO_CONDENSED_21));
-  text_layer_set_text_alignment(s_icon_test_layer, GTextAlignmentLeft);
-  // Initially empty; will be populated with the OWM icon code (e.g. "01d")
-  text_layer_set_text(s_icon_test_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_icon_test_layer));
-
-  // Date above time: left-justified and using LECO if available, otherwise fallback
-  const int DATE_H = 28;
-  int date_y = time_y - DATE_H - 4;
-  // Make the date left-justified with full-width so text aligns to the left edge
-  s_date_layer = text_layer_create(GRect(0, date_y, bounds.size.w, DATE_H));
-  text_layer_set_background_color(s_date_layer, GColorClear);
-  text_layer_set_text_color(s_date_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  // Try to load a custom LECO font if present in resources. If not present
-  // the build won't define the RESOURCE_ID symbol and this block is skipped.
-  #ifdef RESOURCE_ID_FONT_KONSTRUCT_335
-    s_date_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_KONSTRUCT_33));
-  #endif
-  if (s_date_font) {
-    text_layer_set_font(s_date_layer, s_date_font);
-  } else {
-    text_layer_set_font(s_date_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  }
-  text_layer_set_text_alignment(s_date_layer, GTextAlignmentLeft);
-  layer_add_child(window_layer, text_layer_get_layer(s_date_layer));
-
-  // Arrange top-row: center the sky icon and temperature as a group, put
-  // humidity on the left, and min/max on the right.
-  const int ICON_SIZE = 16;
-  const int GAP = 4;
-  int top_metric_y = -4; // small top margin
-
-  // Combined group width: icon + gap + temp width
-  const int TEMP_W = 60;
-  int combined_w = ICON_SIZE + GAP + TEMP_W;
-  int center_x = bounds.size.w / 2;
-  int group_left = center_x - (combined_w / 2);
-
-  // Sky icon (left of the temp within the centered group)
-  int sky_x = group_left;
-  int sky_y = 0;
-  // Glyph layer (WeatherIcons font) placed where the old sky icon was.
-  s_sky_glyph_layer = text_layer_create(GRect(sky_x, sky_y, ICON_SIZE, ICON_SIZE));
-  text_layer_set_background_color(s_sky_glyph_layer, GColorClear);
-  text_layer_set_text_color(s_sky_glyph_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_sky_font) text_layer_set_font(s_sky_glyph_layer, s_sky_font);
-  else if (s_icon_font) text_layer_set_font(s_sky_glyph_layer, s_icon_font);
-  else text_layer_set_font(s_sky_glyph_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_text_alignment(s_sky_glyph_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_sky_glyph_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_sky_glyph_layer));
-  // Show glyph layer by default (procedural icons removed)
-  layer_set_hidden(text_layer_get_layer(s_sky_glyph_layer), false);
-
-  // Temperature immediately to the right of the icon, part of the centered group
-  int temp_x = group_left + ICON_SIZE + GAP;
-  s_temperature_layer = text_layer_create(GRect(temp_x, top_metric_y, TEMP_W, 20));
-  text_layer_set_background_color(s_temperature_layer, GColorClear);
-  text_layer_set_text_color(s_temperature_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_temperature_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_temperature_layer, GTextAlignmentLeft);
-  layer_add_child(window_layer, text_layer_get_layer(s_temperature_layer));
-
-  // Humidity on the left edge (no x offset)
-  int hum_w = 60;
-  int hum_x = 0;
-  s_humidity_layer = text_layer_create(GRect(hum_x, top_metric_y, hum_w, 20));
-  text_layer_set_background_color(s_humidity_layer, GColorClear);
-  text_layer_set_text_color(s_humidity_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_humidity_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_text_alignment(s_humidity_layer, GTextAlignmentLeft);
-  layer_add_child(window_layer, text_layer_get_layer(s_humidity_layer));
-
-  // Min/max on the right edge
-  s_minmax_layer = text_layer_create(GRect(bounds.size.w - 86, top_metric_y, 86, 20));
-  text_layer_set_background_color(s_minmax_layer, GColorClear);
-  text_layer_set_text_color(s_minmax_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_minmax_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_text_alignment(s_minmax_layer, GTextAlignmentRight);
-  layer_add_child(window_layer, text_layer_get_layer(s_minmax_layer));
-
-  // Position sunrise/sunset at the very bottom, status line just above it
-  /* Adjusted for smaller suntime font (14px): make the sun lines shorter and
-    reduce bottom margin so they sit closer to the screen bottom. */
-  const int SUN_HEIGHT = 14;
-  const int STATUS_HEIGHT = 18;
-  const int BOTTOM_MARGIN = 2;
-  // Sunrise left, sunset right at the very bottom
-  GRect sunrise_frame = GRect(4, bounds.size.h - SUN_HEIGHT - BOTTOM_MARGIN, bounds.size.w/2 - 4, SUN_HEIGHT);
-  GRect sunset_frame = GRect(bounds.size.w/2, bounds.size.h - SUN_HEIGHT - BOTTOM_MARGIN, bounds.size.w/2 - 4, SUN_HEIGHT);
-  s_sunrise_layer = text_layer_create(sunrise_frame);
-  text_layer_set_background_color(s_sunrise_layer, GColorClear);
-  text_layer_set_text_color(s_sunrise_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_sunrise_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_sunrise_layer, GTextAlignmentLeft);
-  layer_add_child(window_layer, text_layer_get_layer(s_sunrise_layer));
-
-  s_sunset_layer = text_layer_create(sunset_frame);
-  text_layer_set_background_color(s_sunset_layer, GColorClear);
-  text_layer_set_text_color(s_sunset_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_sunset_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_sunset_layer, GTextAlignmentRight);
-  layer_add_child(window_layer, text_layer_get_layer(s_sunset_layer));
-
-  // Status line: place it on the same baseline as the sunrise/sunset
-  // and centered horizontally between them. Use the smaller sun font
-  // height so it doesn't overlap the sunrise/sunset texts.
-  const int STATUS_WIDTH = bounds.size.w / 2;
-  const int STATUS_X = bounds.size.w / 4;
-  GRect status_frame = GRect(STATUS_X, bounds.size.h - STATUS_HEIGHT - BOTTOM_MARGIN, STATUS_WIDTH, STATUS_HEIGHT);
-  s_status_layer = text_layer_create(status_frame);
-  text_layer_set_background_color(s_status_layer, GColorClear);
-  text_layer_set_text_color(s_status_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  text_layer_set_font(s_status_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_text_alignment(s_status_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_status_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_status_layer));
-  // Ensure status line is visible in normal operation
-  layer_set_hidden(text_layer_get_layer(s_status_layer), false);
+  render_init(window_layer, s_dark_mode ? GColorWhite : GColorBlack);
+
+  // Main time, vertically centered, in LECO 47 where the platform has it
+  prv_add_slot(RENDER_TIME, layout->time, GTextAlignmentCenter);
+
+  // Icon row directly underneath the time: the WeatherIcons glyph and the raw
+  // OWM icon code (in a readable Roboto), both hidden until the
+  // companion/module provides them.
+  prv_add_slot(RENDER_ICON_GLYPH, layout->icon_glyph, GTextAlignmentCenter);
+  prv_add_slot(RENDER_ICON_TEST, layout->icon_test, GTextAlignmentLeft);
+
+  // Date above time, left-justified
+  prv_add_slot(RENDER_DATE, layout->date, GTextAlignmentLeft);
+
+  // Top row: the sky glyph and temperature form a centered group, humidity
+  // sits on the left and min/max on the right.
+  prv_add_slot(RENDER_SKY_GLYPH, layout->sky_glyph, GTextAlignmentCenter);
+  s_temp_frame = layout->temperature;
+  s_temp_font = font_registry_acquire(s_slot_fonts[RENDER_TEMPERATURE]);
+  render_add_slot(RENDER_TEMPERATURE, s_temp_frame, s_temp_font, GTextAlignmentLeft);
+  render_set_overflow_mode(RENDER_TEMPERATURE, GTextOverflowModeTrailingEllipsis);
+  prv_add_slot(RENDER_HUMIDITY, layout->humidity, GTextAlignmentLeft);
+  prv_add_slot(RENDER_MINMAX, layout->minmax, GTextAlignmentRight);
+
+  // Sunrise left, sunset right at the bottom, in the small 14px font
+  prv_add_slot(RENDER_SUNRISE, layout->sunrise, GTextAlignmentLeft);
+  prv_add_slot(RENDER_SUNSET, layout->sunset, GTextAlignmentRight);
+
+  // Status line, centered between sunrise and sunset on rectangular screens
+  // (below them on round ones)
+  prv_add_slot(RENDER_STATUS, layout->status, GTextAlignmentCenter);
+  s_window_loaded = true;
+
+  // Fixed frames the temperature group is laid out against
+  s_bounds = bounds;
+  s_sky_frame = layout->sky_glyph;
+  s_hum_frame = layout->humidity;
+  s_minmax_frame = layout->minmax;
 
   // Add a Select-button handler to run a local weather test (useful in emulator)
   window_set_click_config_provider(window, prv_click_config_provider);
 
 
   prv_update_time();
+  // Fresh layers: every complication needs its first format pass
+  s_dirty = DIRTY_ALL;
   prv_format_and_update_weather();
+  mem_stats_sample(MEM_CHECKPOINT_WINDOW_LOAD);
 }
 
 static void prv_window_unload(Window *window) {
-  text_layer_destroy(s_time_layer);
-  text_layer_destroy(s_date_layer);
-  text_layer_destroy(s_temperature_layer);
-  text_layer_destroy(s_humidity_layer);
-  text_layer_destroy(s_minmax_layer);
-  text_layer_destroy(s_sky_glyph_layer);
-  text_layer_destroy(s_icon_glyph_layer);
-  text_layer_destroy(s_icon_test_layer);
-  // Procedural sky layer removed; nothing to destroy here.
-  text_layer_destroy(s_sunrise_layer);
-  text_layer_destroy(s_sunset_layer);
-  text_layer_destroy(s_status_layer);
-  // Unload custom fonts if loaded
-  #ifdef RESOURCE_ID_FONT_PROTOTYPE_48
-    if (s_time_font) fonts_unload_custom_font(s_time_font);
-  #endif
-  #ifdef RESOURCE_ID_FONT_LECO_BOLD
-    if (s_date_font) fonts_unload_custom_font(s_date_font);
-  #endif
-  #ifdef RESOURCE_ID_FONT_WEATHER_24
-    if (s_icon_font) fonts_unload_custom_font(s_icon_font);
-  #endif
-  #ifdef RESOURCE_ID_FONT_WEATHER_12
-    if (s_sky_font) fonts_unload_custom_font(s_sky_font);
-  #endif
+  s_window_loaded = false;
+  render_deinit();
+  // One release per slot, matching the acquires in prv_window_load
+  for (int i = 0; i < RENDER_SLOT_COUNT; i++) {
+    font_registry_release(s_slot_fonts[i]);
+  }
+  s_temp_font = NULL;
+  // Cached widths are keyed by font handles that are no longer valid
+  memset(s_width_cache, 0, sizeof(s_width_cache));
 }
 
 static void prv_init(void) {
@@ -613,31 +566,46 @@ static void prv_init(void) {
   });
   window_stack_push(s_window, true);
 
-  // AppMessage
-  app_message_register_inbox_received(prv_inbox_received);
-  app_message_register_inbox_dropped(prv_inbox_dropped);
-  app_message_register_outbox_failed(prv_outbox_failed);
-  app_message_register_outbox_sent(prv_outbox_sent);
+  // AppMessage, BT and battery all go through the event bus, which owns the
+  // service subscriptions; inbox tuples are dispatched by key through the
+  // message router
+  event_bus_init();
+  if (event_bus_subscribe(&(event_bus_listener_t) {
+        .bt = prv_bluetooth_callback,
+        .battery = prv_battery_callback,
+      }) < 0) {
+    LOG_ERROR("No event bus slot for BT/battery status");
+  }
+  msg_router_init();
+  msg_router_register(MESSAGE_KEY_BT_CONNECTED, MESSAGE_KEY_DARK_MODE, prv_inbox_tuple, prv_inbox_done, NULL);
+  msg_router_register(MESSAGE_KEY_MEMORY_REPORT, MESSAGE_KEY_COUNTERS, prv_inbox_tuple, prv_inbox_done, NULL);
   const uint32_t inbox_size = 256;
   const uint32_t outbox_size = 256;
   app_message_open(inbox_size, outbox_size);
 
-  // Tick, BT and battery
-  tick_timer_service_subscribe(MINUTE_UNIT, prv_tick_handler);
-  bluetooth_connection_service_subscribe(prv_bluetooth_callback);
-  battery_state_service_subscribe(prv_battery_callback);
+  // All tick consumers go through the dispatcher, which owns the single
+  // TickTimerService subscription.
+  tick_dispatch_init();
+  if (tick_dispatch_register(MINUTE_UNIT, 1, prv_tick_handler, NULL) < 0) {
+    LOG_ERROR("No tick slot for the clock");
+  }
+  if (tick_dispatch_register(DAY_UNIT, 1, prv_day_handler, NULL) < 0) {
+    LOG_ERROR("No tick slot for the daily counters save");
+  }
 
-  // Initialize status: set previous BT state to the current state so we don't treat
-  // the initial condition as a disconnected->connected transition.
-  s_prev_bt_connected = bluetooth_connection_service_peek();
-  prv_bluetooth_callback(s_prev_bt_connected);
-  prv_battery_callback(battery_state_service_peek());
+  // Initial status from the bus's current state. This is not a transition,
+  // so no weather request is triggered here.
+  s_bt_connected = event_bus_bt_connected();
+  s_battery_level = event_bus_battery().charge_percent;
+  s_dirty |= DIRTY_STATUS;
+  prv_format_and_update_weather();
 
   // Initialize weather module and register callback
   weather_init(weather_module_cb, NULL);
 
-  // Start periodic weather refresh (module will force an initial request).
-  weather_start_periodic(20);
+  // Start periodic weather refresh at the configured base interval (module
+  // will force an initial request).
+  weather_start_periodic(weather_get_policy()->poll_minutes);
 }
 
 static void prv_set_dark_mode(bool enable) {
@@ -646,32 +614,30 @@ static void prv_set_dark_mode(bool enable) {
   if (s_window) {
     // Update background color immediately
     window_set_background_color(s_window, s_dark_mode ? GColorBlack : GColorWhite);
-    // Reformat and update text colors/content
-    if (s_date_layer) text_layer_set_text_color(s_date_layer, s_dark_mode ? GColorWhite : GColorBlack);
-    if (s_time_layer) text_layer_set_text_color(s_time_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_temperature_layer) text_layer_set_text_color(s_temperature_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_humidity_layer) text_layer_set_text_color(s_humidity_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_minmax_layer) text_layer_set_text_color(s_minmax_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_sunrise_layer) text_layer_set_text_color(s_sunrise_layer, s_dark_mode ? GColorWhite : GColorBlack);
-  if (s_sunset_layer) text_layer_set_text_color(s_sunset_layer, s_dark_mode ? GColorWhite : GColorBlack);
-    if (s_status_layer) text_layer_set_text_color(s_status_layer, s_dark_mode ? GColorWhite : GColorBlack);
+    // Recolor every complication
+    if (s_window_loaded) render_set_text_color(s_dark_mode ? GColorWhite : GColorBlack);
   }
 }
 
 static void prv_deinit(void) {
-  bluetooth_connection_service_unsubscribe();
-  battery_state_service_unsubscribe();
-  tick_timer_service_unsubscribe();
-  app_message_deregister_callbacks();
   weather_deinit();
-  // Stop periodic polling (if enabled)
+  // Stop periodic polling (if enabled), then release the tick subscription
   weather_stop_periodic();
+  tick_dispatch_deinit();
+  msg_router_deinit();
+  event_bus_deinit();
   window_destroy(s_window);
+  counters_persist();
 }
 
 int main(void) {
+  // Stack depths are measured from main()'s frame
+  char stack_base;
+  mem_stats_init(&stack_base);
+  counters_init();
   prv_init();
-  APP_LOG(APP_LOG_LEVEL_INFO, "watchface1 initialized (diorite target)");
+  mem_stats_sample(MEM_CHECKPOINT_INIT);
+  LOG_INFO("watchface1 initialized (diorite target)");
   app_event_loop();
   prv_deinit();
 }
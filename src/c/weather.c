@@ -1,4 +1,11 @@
 #include "weather.h"
+#define LOG_MODULE_LEVEL LOG_LEVEL_WEATHER
+#include "log.h"
+#include "tick_dispatch.h"
+#include "event_bus.h"
+#include "msg_router.h"
+#include "counters.h"
+#include "solar.h"
 #include "message_keys.auto.h"
 // Fallback for SKY_GLYPH message key if generated header isn't up-to-date.
 #ifndef MESSAGE_KEY_SKY_GLYPH
@@ -8,176 +15,818 @@
 #define MESSAGE_KEY_SKY_ICON 10008
 #endif
 
-/* C-side glyph mapping removed - companion handles all mapping */
+#ifndef MESSAGE_KEY_WEATHER_PACKED
+#define MESSAGE_KEY_WEATHER_PACKED 10014
+#endif
+#ifndef MESSAGE_KEY_SNAPSHOT_HASH
+#define MESSAGE_KEY_SNAPSHOT_HASH 10015
+#endif
+#ifndef MESSAGE_KEY_WEATHER_DELTA
+#define MESSAGE_KEY_WEATHER_DELTA 10016
+#endif
+#ifndef MESSAGE_KEY_WEATHER_FORECAST
+#define MESSAGE_KEY_WEATHER_FORECAST 10017
+#endif
+#ifndef MESSAGE_KEY_LOCATION
+#define MESSAGE_KEY_LOCATION 10018
+#endif
+#ifndef MESSAGE_KEY_CITY
+#define MESSAGE_KEY_CITY 10013
+#endif
+#ifndef MESSAGE_KEY_POLL_MINUTES
+#define MESSAGE_KEY_POLL_MINUTES 10022
+#endif
+#ifndef MESSAGE_KEY_REQUEST_COOLDOWN
+#define MESSAGE_KEY_REQUEST_COOLDOWN 10023
+#endif
+#ifndef MESSAGE_KEY_RETRY_BASE
+#define MESSAGE_KEY_RETRY_BASE 10024
+#endif
+#ifndef MESSAGE_KEY_RETRY_MAX_INTERVAL
+#define MESSAGE_KEY_RETRY_MAX_INTERVAL 10025
+#endif
+#ifndef MESSAGE_KEY_MAX_RETRIES
+#define MESSAGE_KEY_MAX_RETRIES 10026
+#endif
+
+/* Glyph choice stays with the companion: legacy payloads carry the glyph
+   string itself, packed payloads carry an index into s_icon_map below whose
+   glyph table mirrors iconToGlyph in src/pkjs/index.js. */
+
+/* OWM icon codes and their WeatherIcons glyphs (UTF-8). The row index is the
+   icon byte of the packed payload, so rows must stay in the same order as
+   ICON_CODES in src/pkjs/index.js; append new codes at the end. */
+static const struct { const char *code; const char *glyph; } s_icon_map[] = {
+  { "01d", "" }, // clear sky day 
+  { "02d", "" }, // few clouds day 
+  { "03d", "" }, // scattered clouds day
+  { "04d", "" }, // broken clouds day
+  { "09d", "" }, // shower rain day 
+  { "10d", "" }, // rain day 
+  { "11d", "" }, // thunderstorm day 
+  { "13d", "" }, // snow day 
+  { "50d", "" }, // mist day 
+  { "01n", "" }, // clear sky night 
+  { "02n", "" }, // few clouds night 
+  { "03n", "" }, // scattered clouds night 
+  { "04n", "" }, // broken clouds night
+  { "09n", "" }, // shower rain night 
+  { "10n", "" }, // rain night 
+  { "11n", "" }, // thunderstorm night 
+  { "13n", "" }, // snow night 
+  { "50n", "" }, // mist night 
+};
+#define ICON_MAP_COUNT ((int)(sizeof(s_icon_map) / sizeof(s_icon_map[0])))
+
+/* Map OWM icon code string to its glyph. Returns the glyph string if a
+   mapping exists, otherwise empty string. */
+static const char *map_icon_code_to_glyph(const char *icon_code) {
+  if (!icon_code || !icon_code[0]) return "";
+  for (int i = 0; i < ICON_MAP_COUNT; ++i) {
+    if (strcmp(icon_code, s_icon_map[i].code) == 0) return s_icon_map[i].glyph;
+  }
+  return "";
+}
+
+/* Icon byte from a packed payload to OWM icon code ("" for none/unknown). */
+const char *weather_icon_code(uint8_t index) {
+  return (index < ICON_MAP_COUNT) ? s_icon_map[index].code : "";
+}
+
+/* REQUEST_WEATHER: fixed numeric key the companion listens for. */
+#define WEATHER_REQUEST_KEY 100
+
+/* Temperature jump (degrees) between payloads treated as volatile weather. */
+#define WEATHER_VOLATILE_TEMP_DELTA 2
+
+/* Persisted snapshot of the last good weather so a restart can draw real
+   values immediately. Persist keys 100+ belong to the weather module; the
+   app's own keys (watchface1.c) start at 1. */
+#define PERSIST_KEY_WEATHER_SNAPSHOT 100
+#define PERSIST_KEY_WEATHER_LAST_REQUEST 101
+#define PERSIST_KEY_WEATHER_STARTUPS 102
+#define PERSIST_KEY_WEATHER_LOCATION 103
+#define PERSIST_KEY_WEATHER_POLICY 104
+#define WEATHER_POLICY_VERSION 1
+#define WEATHER_SNAPSHOT_VERSION 3
+/* Rewrite the snapshot on unchanged payloads at most this often (seconds),
+   so its timestamp stays meaningful without a flash write per poll. */
+#define WEATHER_SNAPSHOT_REFRESH (60 * 60)
+#define WEATHER_DEFAULT_STALE_AGE (2 * 60 * 60)
+
+typedef struct {
+  uint8_t version;
+  time_t updated_at;
+  weather_data_t data;
+  uint32_t city_hash;
+  uint32_t snapshot_hash;
+  uint8_t packed[WEATHER_PACKED_V1_SIZE];
+} weather_snapshot_t;
+_Static_assert(sizeof(weather_snapshot_t) <= PERSIST_DATA_MAX_LENGTH, "weather snapshot exceeds one persist slot");
 
 /* Internal state */
 static weather_data_t s_data = {0};
+static time_t s_updated_at = 0;  /* last weather payload received (or restored) */
+static time_t s_timeline_at = 0; /* start of the forecast slot shown, if newer */
+static time_t s_saved_at = 0;    /* updated_at of the persisted snapshot */
+static uint32_t s_stale_age = WEATHER_DEFAULT_STALE_AGE;
+static time_t s_last_request = 0; /* last request handed to the outbox */
+static time_t s_last_request_saved = 0; /* s_last_request as persisted */
+static weather_startup_stats_t s_startups = {0}; /* persisted launch counters */
+static AppTimer *s_startup_timer = NULL; /* fast path: first poll of this launch */
+static int s_timeline_handle = -1; /* tick dispatcher handle of the timeline */
 static weather_update_callback s_callback = NULL;
 static void *s_callback_ctx = NULL;
+static uint32_t s_city_hash = 0; /* hash of s_data.city as sent by the companion */
+static uint8_t s_packed[WEATHER_PACKED_V1_SIZE]; /* last applied packed record */
+static uint32_t s_snapshot_hash = 0; /* FNV-1a of s_packed; 0 = none applied */
+/* Last LOCATION from the companion (1e-4 degrees), persisted; sun times are
+   computed from it on the watch. */
+typedef struct {
+  int32_t lat_e4;
+  int32_t lon_e4;
+} weather_location_t;
+static weather_location_t s_location;
+static bool s_has_location = false;
+/* Refresh policy (weather.h); replaced from the companion's settings */
+static weather_policy_t s_policy = {
+  .poll_minutes = 20,
+  .cooldown_seconds = 9 * 60, /* within the 10 min volatile interval */
+  .retry_base_seconds = 30,
+  .retry_max_seconds = 10 * 60,
+  .max_retries = 8,
+};
+typedef struct {
+  uint8_t version;
+  weather_policy_t policy;
+} weather_policy_record_t;
+static int s_sun_handle = -1; /* tick dispatcher handle of the daily sun update */
+static int s_bus_handle = -1; /* event bus handle: payloads, request delivery, BT */
 
 /* Forward declarations for functions used before their definitions */
-static void weather_bt_handler(bool connected);
+static void weather_bt_handler(bool connected, void *ctx);
+static void weather_battery_handler(BatteryChargeState state, void *ctx);
+static void weather_tuple_handler(const Tuple *t, void *ctx);
+static void weather_inbox_done(void *ctx);
+static void weather_outbox_sent_handler(DictionaryIterator *iter, void *ctx);
+static void weather_outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *ctx);
 static void schedule_weather_retry(void);
 static void cancel_weather_retry(void);
+static void adapt_poll_after_payload(bool changed, bool volatile_change);
+static void end_in_flight(void);
+static void request_answered(void);
+static void update_poll_interval(void);
+static bool advance_timeline(time_t now);
+static void timeline_tick_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx);
+static bool update_sun_times(time_t now);
+static void sun_day_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx);
+static void load_policy(void);
+static void policy_tuple_handler(const Tuple *t, void *ctx);
+static void policy_inbox_done(void *ctx);
+
+static void save_snapshot(void) {
+  weather_snapshot_t snap = {
+    .version = WEATHER_SNAPSHOT_VERSION,
+    .updated_at = s_updated_at,
+    .data = s_data,
+    .city_hash = s_city_hash,
+    .snapshot_hash = s_snapshot_hash,
+  };
+  memcpy(snap.packed, s_packed, sizeof(snap.packed));
+  if (persist_write_data(PERSIST_KEY_WEATHER_SNAPSHOT, &snap, sizeof(snap)) < 0) {
+    LOG_WARN("Failed to persist weather snapshot");
+    return;
+  }
+  s_saved_at = s_updated_at;
+}
+
+/* Returns true if a snapshot of the current version was restored. */
+static bool restore_snapshot(void) {
+  if (!persist_exists(PERSIST_KEY_WEATHER_SNAPSHOT)) return false;
+  weather_snapshot_t snap;
+  int read = persist_read_data(PERSIST_KEY_WEATHER_SNAPSHOT, &snap, sizeof(snap));
+  if (read != (int)sizeof(snap) || snap.version != WEATHER_SNAPSHOT_VERSION) {
+    LOG_INFO("Ignoring incompatible weather snapshot");
+    return false;
+  }
+  s_data = snap.data;
+  s_data.city[sizeof(s_data.city)-1] = '\0';
+  s_data.glyph[sizeof(s_data.glyph)-1] = '\0';
+  s_data.icon_code[sizeof(s_data.icon_code)-1] = '\0';
+  s_updated_at = s_saved_at = snap.updated_at;
+  s_city_hash = snap.city_hash;
+  s_snapshot_hash = snap.snapshot_hash;
+  memcpy(s_packed, snap.packed, sizeof(s_packed));
+  return true;
+}
 
 void weather_init(weather_update_callback cb, void *ctx) {
   s_callback = cb;
   s_callback_ctx = ctx;
   memset(&s_data, 0, sizeof(s_data));
-  // Subscribe to BT events so retries can resume on reconnect
-  bluetooth_connection_service_subscribe(weather_bt_handler);
+  s_updated_at = s_saved_at = 0;
+  s_timeline_at = 0;
+  s_has_location = persist_read_data(PERSIST_KEY_WEATHER_LOCATION, &s_location, sizeof(s_location)) == (int)sizeof(s_location);
+  // Show the last good snapshot right away instead of placeholders
+  bool restored = restore_snapshot();
+  if (restored) {
+    LOG_INFO("Restored weather snapshot (age %ds)", (int)(time(NULL) - s_updated_at));
+    // Catch up with forecast slots that started while we weren't running
+    advance_timeline(time(NULL));
+  }
+  // The snapshot's sun times may be from an earlier day
+  if (update_sun_times(time(NULL)) || restored) {
+    if (s_callback) s_callback(&s_data, s_callback_ctx);
+  }
+  s_timeline_handle = tick_dispatch_register(MINUTE_UNIT, 1, timeline_tick_handler, NULL);
+  if (s_timeline_handle < 0) LOG_ERROR("No tick slot for the forecast timeline");
+  s_sun_handle = tick_dispatch_register(DAY_UNIT, 1, sun_day_handler, NULL);
+  if (s_sun_handle < 0) LOG_ERROR("No tick slot for the daily sun times");
+  if (persist_exists(PERSIST_KEY_WEATHER_LAST_REQUEST)) {
+    s_last_request = (time_t)persist_read_int(PERSIST_KEY_WEATHER_LAST_REQUEST);
+  }
+  s_last_request_saved = s_last_request;
+  if (persist_read_data(PERSIST_KEY_WEATHER_STARTUPS, &s_startups, sizeof(s_startups)) != (int)sizeof(s_startups)) {
+    memset(&s_startups, 0, sizeof(s_startups));
+  }
+  load_policy();
+  // Weather keys: the legacy per-key payload, then city through location
+  msg_router_register(MESSAGE_KEY_WEATHER_TEMP, MESSAGE_KEY_SKY_ICON, weather_tuple_handler, weather_inbox_done, NULL);
+  msg_router_register(MESSAGE_KEY_CITY, MESSAGE_KEY_LOCATION, weather_tuple_handler, weather_inbox_done, NULL);
+  // Refresh policy from the settings page
+  msg_router_register(MESSAGE_KEY_POLL_MINUTES, MESSAGE_KEY_MAX_RETRIES, policy_tuple_handler, policy_inbox_done, NULL);
+  // Request delivery, BT so retries can resume on reconnect, and battery
+  // for the poll policy
+  s_bus_handle = event_bus_subscribe(&(event_bus_listener_t) {
+    .bt = weather_bt_handler,
+    .battery = weather_battery_handler,
+    .outbox_sent = weather_outbox_sent_handler,
+    .outbox_failed = weather_outbox_failed_handler,
+  });
+  if (s_bus_handle < 0) LOG_ERROR("No event bus slot; requests will not be retried");
 }
 
 void weather_deinit(void) {
   s_callback = NULL;
   s_callback_ctx = NULL;
-  // Cancel any pending retry and unsubscribe from BT
+  // Cancel any pending retry/response/startup timers and leave the bus
   cancel_weather_retry();
-  bluetooth_connection_service_unsubscribe();
+  end_in_flight();
+  if (s_startup_timer) {
+    app_timer_cancel(s_startup_timer);
+    s_startup_timer = NULL;
+  }
+  event_bus_unsubscribe(s_bus_handle);
+  s_bus_handle = -1;
+  tick_dispatch_unregister(s_timeline_handle);
+  s_timeline_handle = -1;
+  tick_dispatch_unregister(s_sun_handle);
+  s_sun_handle = -1;
+  // The request time only matters to the next launch; save it once here
+  if (s_last_request != s_last_request_saved) {
+    persist_write_int(PERSIST_KEY_WEATHER_LAST_REQUEST, (int32_t)s_last_request);
+    s_last_request_saved = s_last_request;
+  }
 }
 
 const weather_data_t *weather_get(void) {
   return &s_data;
 }
 
+/* Counting wrappers around the radio/timer calls so the cost of the polling
+   policy can be compared across releases (see counters.h). Delivery
+   failures are counted by the event bus; only sends the outbox refuses
+   outright are counted here. */
+static AppMessageResult counted_outbox_send(void) {
+  counters_inc(COUNTER_WEATHER_REQUESTS);
+  AppMessageResult res = app_message_outbox_send();
+  if (res != APP_MSG_OK) counters_inc(COUNTER_OUTBOX_FAILED);
+  return res;
+}
+
+static AppTimer *counted_timer_register(uint32_t timeout_ms, AppTimerCallback cb) {
+  counters_inc(COUNTER_WEATHER_TIMERS);
+  return app_timer_register(timeout_ms, cb, NULL);
+}
+
 static void notify_if_needed(void) {
   // Per design: do NOT synthesize a glyph from the icon_code. Only use
   // an explicit glyph provided by the companion (MESSAGE_KEY_SKY_GLYPH).
   // If no glyph was provided, leave s_data.glyph empty so the UI can
   // decide to hide glyphs. This matches the user's instruction to rely
   // solely on the OWM icon string/glyph provided by the companion.
-  APP_LOG(APP_LOG_LEVEL_INFO, "notify_if_needed: glyph='%s' (len=%d) icon='%s' temp=%d", 
+  LOG_DEBUG("notify_if_needed: glyph='%s' (len=%d) icon='%s' temp=%d", 
           s_data.glyph, (int)strlen(s_data.glyph), s_data.icon_code, s_data.temp);
+  save_snapshot();
   if (s_callback) s_callback(&s_data, s_callback_ctx);
 }
 
-void weather_handle_inbox(DictionaryIterator *iter) {
-  bool changed = false;
-  Tuple *t;
-  t = dict_find(iter, MESSAGE_KEY_WEATHER_TEMP);
-  if (t) { int v = (int)t->value->int32; if (v != s_data.temp) { s_data.temp = v; changed = true; } }
-  t = dict_find(iter, MESSAGE_KEY_WEATHER_HUMIDITY);
-  if (t) { int v = (int)t->value->int32; if (v != s_data.humidity) { s_data.humidity = v; changed = true; } }
-  t = dict_find(iter, MESSAGE_KEY_WEATHER_MIN);
-  if (t) { int v = (int)t->value->int32; if (v != s_data.min) { s_data.min = v; changed = true; } }
-  t = dict_find(iter, MESSAGE_KEY_WEATHER_MAX);
-  if (t) { int v = (int)t->value->int32; if (v != s_data.max) { s_data.max = v; changed = true; } }
-  t = dict_find(iter, MESSAGE_KEY_SUNRISE);
+time_t weather_get_updated_at(void) {
+  return s_updated_at;
+}
+
+void weather_set_stale_age(uint32_t seconds) {
+  s_stale_age = seconds;
+}
+
+bool weather_is_stale(void) {
+  if (!s_updated_at) return false; /* nothing to be stale yet; UI shows placeholders */
+  time_t now = time(NULL);
+  /* A pending slot means the one shown still covers now; the timeline poll
+     interval is longer than the stale age, so this is the normal case. */
+  if (s_data.forecast_count && s_data.forecast[s_data.forecast_head].time > now) return false;
+  time_t fresh_at = (s_timeline_at > s_updated_at) ? s_timeline_at : s_updated_at;
+  return (uint32_t)(now - fresh_at) > s_stale_age;
+}
+
+/* Copy a companion string into a fixed-size field; returns true if it changed. */
+static bool set_string_field(char *dst, size_t size, const char *src) {
+  if (strncmp(dst, src, size - 1) == 0) return false;
+  strncpy(dst, src, size - 1);
+  dst[size - 1] = '\0';
+  return true;
+}
+
+/* 32-bit FNV-1a, matching fnv1a() in src/pkjs/index.js. */
+static uint32_t fnv1a(const uint8_t *p, size_t len) {
+  uint32_t h = 2166136261u;
+  while (len--) {
+    h ^= *p++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static uint32_t city_hash(const char *s) {
+  return fnv1a((const uint8_t *)s, strlen(s));
+}
+
+/* Set a sun time and its cached local "HH:MM" text ("" when unknown), so the
+   UI never needs localtime/strftime for it. Returns true if it changed. */
+static bool set_sun_time(time_t *field, char *text, size_t size, time_t val) {
+  if (val == *field) return false;
+  *field = val;
+  text[0] = '\0';
+  struct tm *tm = val ? localtime(&val) : NULL;
+  if (tm) strftime(text, size, "%H:%M", tm);
+  return true;
+}
+
+/* Sunrise/sunset of today's local date at the last known location. The sun
+   times change by a minute or two per day, so this runs at launch, at local
+   midnight and when the location moves. Returns true if s_data changed. */
+static bool update_sun_times(time_t now) {
+  if (!s_has_location) return false;
+  struct tm *tm = localtime(&now);
+  if (!tm) return false;
+  solar_times_t sun;
+  int32_t day = solar_days_from_civil(tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday);
+  solar_compute(s_location.lat_e4, s_location.lon_e4, day, &sun); /* 0/0 in polar day/night */
+  bool changed = set_sun_time(&s_data.sunrise, s_data.sunrise_text, sizeof(s_data.sunrise_text), sun.sunrise);
+  if (set_sun_time(&s_data.sunset, s_data.sunset_text, sizeof(s_data.sunset_text), sun.sunset)) changed = true;
+  return changed;
+}
+
+static void sun_day_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
+  if (update_sun_times(time(NULL))) notify_if_needed();
+}
+
+/* LOCATION payload (see weather.h). Returns true if s_data changed. */
+static bool handle_location_payload(const Tuple *t) {
+  if (t->type != TUPLE_BYTE_ARRAY || t->length < WEATHER_LOCATION_SIZE) return false;
+  const uint8_t *p = t->value->data;
+  weather_location_t loc = {
+    .lat_e4 = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24)),
+    .lon_e4 = (int32_t)((uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24)),
+  };
+  if (s_has_location && memcmp(&loc, &s_location, sizeof(loc)) == 0) return false;
+  s_location = loc;
+  s_has_location = true;
+  persist_write_data(PERSIST_KEY_WEATHER_LOCATION, &s_location, sizeof(s_location));
+  return update_sun_times(time(NULL));
+}
+
+/* Rebuild an epoch from UTC minutes-of-day, picking the day that puts it
+   within 12 hours of `now` so night detection works across midnight. */
+static time_t epoch_from_utc_minutes(time_t now, uint16_t minutes) {
+  time_t t = now - (now % 86400) + (time_t)minutes * 60;
+  if (t - now > 12 * 3600) t -= 86400;
+  else if (now - t > 12 * 3600) t += 86400;
+  return t;
+}
+
+/* Weather tuples of the message being routed; see msg_router.h. Filled by
+   the tuple handler and consumed and cleared by the done handler within the
+   same inbox callback. Keyed by t->key rather than by offset: on SDK 4 the
+   MESSAGE_KEY_* values are link-time variables, so nothing here may depend
+   on them being constants. The capacity covers every routed weather key. */
+#define INBOX_MAX_TUPLES 16
+static const Tuple *s_inbox_tuples[INBOX_MAX_TUPLES];
+static uint8_t s_inbox_tuple_count = 0;
+
+static const Tuple *inbox_tuple(uint32_t key) {
+  for (uint8_t i = 0; i < s_inbox_tuple_count; i++) {
+    if (s_inbox_tuples[i]->key == key) return s_inbox_tuples[i];
+  }
+  return NULL;
+}
+
+static void weather_tuple_handler(const Tuple *t, void *ctx) {
+  if (s_inbox_tuple_count < INBOX_MAX_TUPLES) s_inbox_tuples[s_inbox_tuple_count++] = t;
+}
+
+/* Legacy per-key payload. Returns true if the message carried a weather
+   payload (as opposed to settings only). */
+static bool handle_legacy_payload(bool *changed, bool *volatile_change) {
+  const Tuple *t;
+  t = inbox_tuple(MESSAGE_KEY_WEATHER_TEMP);
+  /* Only full weather payloads carry the temperature; use it to tell them
+     apart from settings-only messages for the adaptive poll policy. */
+  bool is_weather_payload = (t != NULL);
+  if (t) {
+    int v = (int)t->value->int32;
+    if (v != s_data.temp) {
+      if (abs(v - s_data.temp) >= WEATHER_VOLATILE_TEMP_DELTA) *volatile_change = true;
+      s_data.temp = v;
+      *changed = true;
+    }
+  }
+  t = inbox_tuple(MESSAGE_KEY_WEATHER_HUMIDITY);
+  if (t) { int v = (int)t->value->int32; if (v != s_data.humidity) { s_data.humidity = v; *changed = true; } }
+  t = inbox_tuple(MESSAGE_KEY_WEATHER_MIN);
+  if (t) { int v = (int)t->value->int32; if (v != s_data.min) { s_data.min = v; *changed = true; } }
+  t = inbox_tuple(MESSAGE_KEY_WEATHER_MAX);
+  if (t) { int v = (int)t->value->int32; if (v != s_data.max) { s_data.max = v; *changed = true; } }
+  t = inbox_tuple(MESSAGE_KEY_SUNRISE);
   if (t) {
     time_t val = 0;
     if (t->type == TUPLE_CSTRING && t->value && t->value->cstring) val = (time_t)strtol(t->value->cstring, NULL, 10);
     else val = (time_t)t->value->int32;
-    if (val != s_data.sunrise) { s_data.sunrise = val; changed = true; }
+    if (set_sun_time(&s_data.sunrise, s_data.sunrise_text, sizeof(s_data.sunrise_text), val)) *changed = true;
   }
-  t = dict_find(iter, MESSAGE_KEY_SUNSET);
+  t = inbox_tuple(MESSAGE_KEY_SUNSET);
   if (t) {
     time_t val = 0;
     if (t->type == TUPLE_CSTRING && t->value && t->value->cstring) val = (time_t)strtol(t->value->cstring, NULL, 10);
     else val = (time_t)t->value->int32;
-    if (val != s_data.sunset) { s_data.sunset = val; changed = true; }
+    if (set_sun_time(&s_data.sunset, s_data.sunset_text, sizeof(s_data.sunset_text), val)) *changed = true;
   }
-  t = dict_find(iter, MESSAGE_KEY_SKY_COND);
+  t = inbox_tuple(MESSAGE_KEY_SKY_COND);
   if (t) {
     int sc = 0;
     if (t->type == TUPLE_CSTRING && t->value && t->value->cstring) sc = atoi(t->value->cstring);
     else sc = (int)t->value->int32;
-    if (sc != s_data.sky_code) { s_data.sky_code = sc; changed = true; }
+    if (sc != s_data.sky_code) { s_data.sky_code = sc; *changed = true; }
   }
-  t = dict_find(iter, MESSAGE_KEY_CITY);
+  t = inbox_tuple(MESSAGE_KEY_SKY_GLYPH);
   if (t && t->type == TUPLE_CSTRING && t->value && t->value->cstring) {
-    if (strncmp(s_data.city, t->value->cstring, sizeof(s_data.city)) != 0) {
-      strncpy(s_data.city, t->value->cstring, sizeof(s_data.city));
-      s_data.city[sizeof(s_data.city)-1] = '\0';
-      changed = true;
+    if (set_string_field(s_data.glyph, sizeof(s_data.glyph), t->value->cstring)) {
+      LOG_DEBUG("Received SKY_GLYPH: '%s' (len=%d)", s_data.glyph, (int)strlen(s_data.glyph));
+      *changed = true;
     }
   }
-  t = dict_find(iter, MESSAGE_KEY_SKY_GLYPH);
+  t = inbox_tuple(MESSAGE_KEY_SKY_ICON);
   if (t && t->type == TUPLE_CSTRING && t->value && t->value->cstring) {
-    if (strncmp(s_data.glyph, t->value->cstring, sizeof(s_data.glyph)) != 0) {
-      strncpy(s_data.glyph, t->value->cstring, sizeof(s_data.glyph));
-      s_data.glyph[sizeof(s_data.glyph)-1] = '\0';
-      APP_LOG(APP_LOG_LEVEL_INFO, "Received SKY_GLYPH: '%s' (len=%d)", s_data.glyph, (int)strlen(s_data.glyph));
-      changed = true;
+    if (set_string_field(s_data.icon_code, sizeof(s_data.icon_code), t->value->cstring)) {
+      LOG_DEBUG("Received SKY_ICON: '%s'", s_data.icon_code);
+      /* A change of sky condition is a sign the weather is on the move */
+      *volatile_change = true;
+      *changed = true;
     }
   }
-  t = dict_find(iter, MESSAGE_KEY_SKY_ICON);
-  if (t && t->type == TUPLE_CSTRING && t->value && t->value->cstring) {
-    if (strncmp(s_data.icon_code, t->value->cstring, sizeof(s_data.icon_code)) != 0) {
-      strncpy(s_data.icon_code, t->value->cstring, sizeof(s_data.icon_code));
-      s_data.icon_code[sizeof(s_data.icon_code)-1] = '\0';
-      APP_LOG(APP_LOG_LEVEL_INFO, "Received SKY_ICON: '%s'", s_data.icon_code);
-      changed = true;
+  return is_weather_payload;
+}
+
+/* Apply the fields of a validated v1 packed record to s_data. */
+static void apply_packed_record(const uint8_t *p, bool *changed, bool *volatile_change) {
+  int temp = (int8_t)p[1];
+  int humidity = p[2];
+  int min = (int8_t)p[3];
+  int max = (int8_t)p[4];
+  uint16_t rise_min = (uint16_t)(p[5] | (p[6] << 8));
+  uint16_t set_min = (uint16_t)(p[7] | (p[8] << 8));
+  uint8_t icon = p[9];
+  uint32_t hash = (uint32_t)p[10] | ((uint32_t)p[11] << 8) | ((uint32_t)p[12] << 16) | ((uint32_t)p[13] << 24);
+
+  if (temp != s_data.temp) {
+    if (abs(temp - s_data.temp) >= WEATHER_VOLATILE_TEMP_DELTA) *volatile_change = true;
+    s_data.temp = temp;
+    *changed = true;
+  }
+  if (humidity != s_data.humidity) { s_data.humidity = humidity; *changed = true; }
+  if (min != s_data.min) { s_data.min = min; *changed = true; }
+  if (max != s_data.max) { s_data.max = max; *changed = true; }
+
+  /* Companions that send LOCATION leave the sun times out (NO_TIME); they
+     are computed locally then, see update_sun_times(). */
+  if (rise_min != WEATHER_PACKED_NO_TIME || set_min != WEATHER_PACKED_NO_TIME) {
+    time_t now = time(NULL);
+    time_t sunrise = (rise_min == WEATHER_PACKED_NO_TIME) ? 0 : epoch_from_utc_minutes(now, rise_min);
+    time_t sunset = 0;
+    if (set_min != WEATHER_PACKED_NO_TIME) {
+      /* Sunset is the first occurrence after sunrise */
+      sunset = sunrise ? sunrise - ((time_t)rise_min * 60) + (time_t)set_min * 60 : epoch_from_utc_minutes(now, set_min);
+      if (sunrise && sunset <= sunrise) sunset += 86400;
     }
+    if (set_sun_time(&s_data.sunrise, s_data.sunrise_text, sizeof(s_data.sunrise_text), sunrise)) *changed = true;
+    if (set_sun_time(&s_data.sunset, s_data.sunset_text, sizeof(s_data.sunset_text), sunset)) *changed = true;
   }
 
-  if (changed) notify_if_needed();
+  /* The icon byte indexes the companion's icon table; its glyph comes from
+     the mirrored table below rather than being chosen on the watch. */
+  const char *code = weather_icon_code(icon);
+  if (set_string_field(s_data.icon_code, sizeof(s_data.icon_code), code)) {
+    *volatile_change = true;
+    *changed = true;
+  }
+  if (set_string_field(s_data.glyph, sizeof(s_data.glyph), map_icon_code_to_glyph(code))) *changed = true;
+
+  /* The city name itself only travels (as CITY) when it changes; a hash
+     mismatch without a name means our copy is stale. */
+  if (hash != s_city_hash) {
+    s_city_hash = hash;
+    if (s_data.city[0]) { s_data.city[0] = '\0'; *changed = true; }
+  }
 }
 
-/* Cooldown management for requests (seconds). Default 10 minutes. */
-static const int WEATHER_COOLDOWN = 10 * 60;
-static time_t s_last_request = 0;
+/* Packed payload (WEATHER_PACKED, see weather.h): a single byte-array tuple
+   decoded in one pass. Returns false if the record is malformed or from an
+   unknown version, in which case the caller falls back to the legacy keys. */
+static bool handle_packed_payload(const Tuple *t, bool *changed, bool *volatile_change) {
+  if (t->type != TUPLE_BYTE_ARRAY || t->length < WEATHER_PACKED_V1_SIZE) return false;
+  const uint8_t *p = t->value->data;
+  if (p[0] != WEATHER_PACKED_VERSION) {
+    LOG_WARN("Unknown packed weather version %d", (int)p[0]);
+    return false;
+  }
+  memcpy(s_packed, p, WEATHER_PACKED_V1_SIZE);
+  s_snapshot_hash = fnv1a(s_packed, WEATHER_PACKED_V1_SIZE);
+  apply_packed_record(s_packed, changed, volatile_change);
+  return true;
+}
 
-/* Forward declare retry helper functions */
-static void schedule_weather_retry(void);
-static void cancel_weather_retry(void);
+/* Delta payload (WEATHER_DELTA, see weather.h): patch the bytes of the last
+   applied packed record. A delta against any other base means the companion
+   and watch disagree, so drop it and ask for a full record. */
+static bool handle_delta_payload(const Tuple *t, bool *changed, bool *volatile_change) {
+  if (t->type != TUPLE_BYTE_ARRAY || t->length < WEATHER_DELTA_HEADER_SIZE) return false;
+  const uint8_t *p = t->value->data;
+  if (p[0] != WEATHER_PACKED_VERSION) return false;
+  uint32_t base = (uint32_t)p[1] | ((uint32_t)p[2] << 8) | ((uint32_t)p[3] << 16) | ((uint32_t)p[4] << 24);
+  uint16_t mask = (uint16_t)(p[5] | (p[6] << 8));
+  if (!s_snapshot_hash || base != s_snapshot_hash) {
+    LOG_WARN("Weather delta base mismatch; requesting full snapshot");
+    s_snapshot_hash = 0;
+    counters_inc(COUNTER_DELTA_MISMATCHES);
+    /* This reply settles the outstanding request; ask again from scratch */
+    end_in_flight();
+    weather_force_request();
+    return false;
+  }
+  if (!mask) {
+    counters_inc(COUNTER_DELTAS_APPLIED);
+    return true; /* companion says nothing changed */
+  }
 
-bool weather_request(void) {
-  time_t now = time(NULL);
-  if (now - s_last_request < WEATHER_COOLDOWN) {
+  /* Patch a copy so a truncated delta leaves the applied record intact */
+  uint8_t patched[WEATHER_PACKED_V1_SIZE];
+  memcpy(patched, s_packed, sizeof(patched));
+  uint16_t pos = WEATHER_DELTA_HEADER_SIZE;
+  for (int i = 1; i < WEATHER_PACKED_V1_SIZE; ++i) {
+    if (!(mask & (1 << i))) continue;
+    if (pos >= t->length) {
+      LOG_WARN("Truncated weather delta (%d bytes)", (int)t->length);
+      return false;
+    }
+    patched[i] = p[pos++];
+  }
+  counters_inc(COUNTER_DELTAS_APPLIED);
+  memcpy(s_packed, patched, sizeof(s_packed));
+  s_snapshot_hash = fnv1a(s_packed, WEATHER_PACKED_V1_SIZE);
+  apply_packed_record(s_packed, changed, volatile_change);
+  return true;
+}
+
+/* Forecast payload (WEATHER_FORECAST, see weather.h): replaces the ring. */
+static bool handle_forecast_payload(const Tuple *t) {
+  if (t->type != TUPLE_BYTE_ARRAY || t->length < WEATHER_FORECAST_HEADER_SIZE) return false;
+  const uint8_t *p = t->value->data;
+  if (p[0] != WEATHER_FORECAST_VERSION) {
+    LOG_WARN("Unknown forecast version %d", (int)p[0]);
     return false;
   }
+  int count = p[1];
+  if (count > WEATHER_FORECAST_SLOTS) count = WEATHER_FORECAST_SLOTS;
+  if (t->length < WEATHER_FORECAST_HEADER_SIZE + count * 3) return false;
+  time_t base = (time_t)((uint32_t)p[2] | ((uint32_t)p[3] << 8) | ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24));
+  int step = p[6] | (p[7] << 8);
+
+  weather_forecast_slot_t ring[WEATHER_FORECAST_SLOTS];
+  memset(ring, 0, sizeof(ring));
+  const uint8_t *slot = p + WEATHER_FORECAST_HEADER_SIZE;
+  for (int i = 0; i < count; ++i, slot += 3) {
+    ring[i].time = base + (time_t)i * step * 60;
+    ring[i].temp = (int8_t)slot[0];
+    ring[i].icon = slot[1];
+    ring[i].pop = slot[2];
+  }
+  if (s_data.forecast_head == 0 && s_data.forecast_count == count &&
+      memcmp(ring, s_data.forecast, sizeof(ring)) == 0) {
+    return false;
+  }
+  memcpy(s_data.forecast, ring, sizeof(ring));
+  s_data.forecast_head = 0;
+  s_data.forecast_count = (uint8_t)count;
+  return true;
+}
+
+/* Forecast timeline. Each minute the timeline tick drops slots whose time
+   has come; the newest slot that started after the last companion update
+   becomes the current conditions, so weather_get() stays current between
+   polls. While enough slots remain the poll policy backs off (see
+   update_poll_interval). Returns true if s_data changed. */
+static bool advance_timeline(time_t now) {
+  const weather_forecast_slot_t *current = NULL;
+  while (s_data.forecast_count && s_data.forecast[s_data.forecast_head].time <= now) {
+    current = &s_data.forecast[s_data.forecast_head];
+    s_data.forecast_head = (s_data.forecast_head + 1) % WEATHER_FORECAST_SLOTS;
+    s_data.forecast_count--;
+  }
+  /* Passed slots older than the last real observation carry nothing new */
+  if (!current || current->time <= s_updated_at) return current != NULL;
+
+  LOG_INFO("Timeline: advancing to forecast slot (temp %d)", (int)current->temp);
+  s_timeline_at = current->time;
+  s_data.temp = current->temp;
+  const char *code = weather_icon_code(current->icon);
+  if (code[0]) {
+    set_string_field(s_data.icon_code, sizeof(s_data.icon_code), code);
+    set_string_field(s_data.glyph, sizeof(s_data.glyph), map_icon_code_to_glyph(code));
+  }
+  return true;
+}
+
+static void timeline_tick_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx) {
+  if (!s_data.forecast_count) return;
+  if (s_data.forecast[s_data.forecast_head].time > time(NULL)) return;
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
+  if (advance_timeline(time(NULL))) {
+    notify_if_needed();
+    update_poll_interval();
+  }
+}
+
+static void weather_inbox_done(void *ctx) {
+  bool changed = false;
+  bool volatile_change = false;
+  bool is_weather_payload = false;
+  const Tuple *t = inbox_tuple(MESSAGE_KEY_WEATHER_PACKED);
+  if (t) is_weather_payload = handle_packed_payload(t, &changed, &volatile_change);
+  if (!is_weather_payload) {
+    t = inbox_tuple(MESSAGE_KEY_WEATHER_DELTA);
+    if (t) is_weather_payload = handle_delta_payload(t, &changed, &volatile_change);
+  }
+  if (!is_weather_payload) is_weather_payload = handle_legacy_payload(&changed, &volatile_change);
+
+  t = inbox_tuple(MESSAGE_KEY_WEATHER_FORECAST);
+  if (t && handle_forecast_payload(t)) changed = true;
+
+  t = inbox_tuple(MESSAGE_KEY_LOCATION);
+  if (t && handle_location_payload(t)) changed = true;
+
+  /* City name is shared by both formats; apply it after the packed hash
+     check so a fresh name is never cleared. */
+  t = inbox_tuple(MESSAGE_KEY_CITY);
+  if (t && t->type == TUPLE_CSTRING && t->value && t->value->cstring) {
+    s_city_hash = city_hash(t->value->cstring);
+    if (set_string_field(s_data.city, sizeof(s_data.city), t->value->cstring)) changed = true;
+  }
+  s_inbox_tuple_count = 0;
+
+  if (is_weather_payload) {
+    request_answered();
+    /* Without a baseline (cold start, no snapshot) every field differs
+       from zero; that says nothing about how fast the weather moves */
+    if (!s_updated_at) volatile_change = false;
+    s_updated_at = time(NULL);
+    /* Drop forecast slots the fresh observation already supersedes; the
+       persisted copy catches up on restore, so this alone is no change */
+    advance_timeline(s_updated_at);
+    adapt_poll_after_payload(changed, volatile_change);
+    /* Unchanged data still refreshes the snapshot age, but only touch flash
+       occasionally for it */
+    if (!changed && s_updated_at - s_saved_at >= WEATHER_SNAPSHOT_REFRESH) save_snapshot();
+  }
+  if (changed) notify_if_needed();
+}
+
+/* Every refresh request carries REQUEST_WEATHER plus the hash of the packed
+   snapshot we hold, which acknowledges it and lets the companion reply with
+   a delta (or an empty "unchanged" delta) instead of the full record. */
+static void write_request_tuples(DictionaryIterator *iter) {
+  dict_write_int8(iter, WEATHER_REQUEST_KEY, 1);
+  dict_write_uint32(iter, MESSAGE_KEY_SNAPSHOT_HASH, s_snapshot_hash);
+}
+
+/* Record a successfully queued request. weather_deinit() persists the time
+   so the cooldown and the startup fast path survive face switches, without
+   a flash write per request. */
+static void note_request_sent(time_t now) {
+  s_last_request = now;
+}
+
+/* Retry scheduling with exponential backoff and indefinite deferral while
+   Bluetooth is disconnected. */
+static AppTimer *s_retry_timer = NULL;
+static int s_retry_count = 0; /* attempts made since the last response */
+static bool s_pending_request = false; /* true when a request needs to be sent */
+
+/* Request pipeline. All triggers (periodic tick, startup, force, retry, BT
+   reconnect) funnel through request_send(). A request is in flight from the
+   moment the outbox accepts it until a weather payload arrives, the outbox
+   reports failure, or the response timeout expires; triggers arriving in
+   that window are merged into the outstanding request. */
+static const int WEATHER_RESPONSE_TIMEOUT = 60; /* seconds; covers GPS + HTTP */
+static bool s_in_flight = false;
+static AppTimer *s_response_timer = NULL;
+
+static void end_in_flight(void) {
+  s_in_flight = false;
+  if (s_response_timer) {
+    app_timer_cancel(s_response_timer);
+    s_response_timer = NULL;
+  }
+}
+
+static void response_timeout_cb(void *data) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
+  s_response_timer = NULL;
+  s_in_flight = false;
+  counters_inc(COUNTER_RESPONSE_TIMEOUTS);
+  LOG_WARN("Weather response timed out");
+  schedule_weather_retry();
+}
+
+/* Returns true if a request was queued or one is already in flight. On a
+   synchronous outbox error a backoff retry is scheduled. */
+static bool request_send(void) {
+  if (s_in_flight) {
+    counters_inc(COUNTER_REQUESTS_COALESCED);
+    return true;
+  }
   DictionaryIterator *iter;
-  if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
-    dict_write_int8(iter, 100, 1);
+  AppMessageResult res = app_message_outbox_begin(&iter);
+  if (res == APP_MSG_OK) {
+    write_request_tuples(iter);
     dict_write_end(iter);
-    AppMessageResult res = app_message_outbox_send();
-    if (res == APP_MSG_OK) {
-      s_last_request = now;
-      // If there was a pending retry, clear it
-      return true;
-    } else {
-      APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_send failed: %d", (int)res);
-      // fall through to schedule retry
-    }
-  } else {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_begin failed (weather_request)");
+    res = counted_outbox_send();
   }
-  // If we get here, sending failed; schedule a retry
-  // (retry state managed below)
-  schedule_weather_retry();
-  return false;
+  if (res != APP_MSG_OK) {
+    LOG_WARN("Weather request send failed: %d", (int)res);
+    schedule_weather_retry();
+    return false;
+  }
+  note_request_sent(time(NULL));
+  s_pending_request = false;
+  s_in_flight = true;
+  s_response_timer = counted_timer_register(WEATHER_RESPONSE_TIMEOUT * 1000, response_timeout_cb);
+  return true;
+}
+
+/* A weather payload answers the outstanding request and ends any backoff. */
+static void request_answered(void) {
+  end_in_flight();
+  cancel_weather_retry();
+}
+
+bool weather_request(void) {
+  time_t now = time(NULL);
+  if (now - s_last_request < s_policy.cooldown_seconds) {
+    counters_inc(COUNTER_COOLDOWN_SKIPS);
+    return false;
+  }
+  return request_send();
 }
 
 void weather_force_request(void) {
   // Try immediate send even if cooldown active. Cancel any pending retries
   // and attempt send now.
   cancel_weather_retry();
-  DictionaryIterator *iter;
-  if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
-    dict_write_int8(iter, 100, 1);
-    dict_write_end(iter);
-    AppMessageResult res = app_message_outbox_send();
-    if (res == APP_MSG_OK) {
-      s_last_request = time(NULL);
-    } else {
-      APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_send failed (force): %d", (int)res);
-      schedule_weather_retry();
-    }
-  } else {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_begin failed (force)");
-    schedule_weather_retry();
-  }
+  request_send();
 }
 
-/* Retry scheduling */
-/* Retry scheduling with exponential backoff and indefinite deferral while
-   Bluetooth is disconnected. */
-static AppTimer *s_retry_timer = NULL;
-static int s_retry_count = 0; /* number of attempts already made */
-static const int WEATHER_RETRY_BASE = 30; /* base interval in seconds */
-static const int WEATHER_RETRY_MAX_INTERVAL = 10 * 60; /* cap to 10 minutes */
-static const int WEATHER_MAX_RETRIES = 8; /* upper attempt cap when connected */
-static bool s_pending_request = false; /* true when a request needs to be sent */
+static void weather_outbox_sent_handler(DictionaryIterator *iter, void *ctx) {
+  if (!dict_find(iter, WEATHER_REQUEST_KEY)) return;
+  LOG_DEBUG("Weather request delivered; awaiting response");
+}
+
+static void weather_outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *ctx) {
+  if (!dict_find(iter, WEATHER_REQUEST_KEY)) return;
+  LOG_WARN("Weather request not delivered: %d", (int)reason);
+  end_in_flight();
+  schedule_weather_retry();
+}
 
 static void cancel_weather_retry(void) {
   if (s_retry_timer) {
@@ -193,135 +842,340 @@ static void cancel_weather_retry(void) {
 static int backoff_interval_seconds(int attempt) {
   if (attempt <= 0) attempt = 1;
   /* Be careful shifting: attempt-1 could be large, but we cap result. */
-  long interval = (long)WEATHER_RETRY_BASE << (attempt - 1);
-  if (interval > WEATHER_RETRY_MAX_INTERVAL) interval = WEATHER_RETRY_MAX_INTERVAL;
+  long interval = (long)s_policy.retry_base_seconds << (attempt - 1);
+  if (interval > s_policy.retry_max_seconds) interval = s_policy.retry_max_seconds;
   return (int)interval;
 }
 
 static void retry_timer_cb(void *data) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
   s_retry_timer = NULL;
   /* If bluetooth disconnected, keep the pending flag and do not consume an
      attempt. Defer until reconnect without incrementing s_retry_count. */
-  if (!bluetooth_connection_service_peek()) {
-    APP_LOG(APP_LOG_LEVEL_INFO, "BT disconnected, deferring weather retry (indefinite)");
+  if (!event_bus_bt_connected()) {
+    LOG_INFO("BT disconnected, deferring weather retry (indefinite)");
     s_pending_request = true;
     return;
   }
-
-  /* Attempt to send again */
-  DictionaryIterator *iter;
-  if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
-    dict_write_int8(iter, 100, 1);
-    dict_write_end(iter);
-    AppMessageResult res = app_message_outbox_send();
-    if (res == APP_MSG_OK) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "Weather retry sent successfully");
-      s_last_request = time(NULL);
-      s_pending_request = false;
-      s_retry_count = 0;
-      return;
-    } else {
-      APP_LOG(APP_LOG_LEVEL_WARNING, "Retry send failed: %d", (int)res);
-    }
-  } else {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_begin failed during retry");
-  }
-
-  /* Sending failed while connected: increment attempt count and schedule next
-     retry using exponential backoff, up to WEATHER_MAX_RETRIES. */
-  s_retry_count++;
-  if (s_retry_count <= WEATHER_MAX_RETRIES) {
-    int interval = backoff_interval_seconds(s_retry_count);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Scheduling weather retry #%d in %d seconds", s_retry_count, interval);
-    s_retry_timer = app_timer_register(interval * 1000, retry_timer_cb, NULL);
-  } else {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "Max weather retries reached; giving up until next trigger");
-    s_pending_request = false;
-    s_retry_count = 0;
-  }
+  /* Attempt to send again; a failure schedules the next backoff step */
+  request_send();
 }
 
 static void schedule_weather_retry(void) {
   /* Mark that a send is pending. If BT is disconnected, we just keep the
      pending flag (indefinite defer). If BT is connected and no timer is
-     active, begin an exponential-backoff retry sequence starting at attempt 1. */
+     active, schedule the next exponential-backoff attempt. Attempts only
+     reset once a response arrives, so synchronous and asynchronous
+     failures (outbox failed, response timeout) share one backoff sequence,
+     capped at the policy's max_retries. */
   s_pending_request = true;
-  if (!bluetooth_connection_service_peek()) {
-    APP_LOG(APP_LOG_LEVEL_INFO, "schedule_weather_retry: BT down, deferring indefinitely");
+  if (!event_bus_bt_connected()) {
+    LOG_INFO("schedule_weather_retry: BT down, deferring indefinitely");
     return;
   }
   if (s_retry_timer) return;
-  s_retry_count = 1;
+  s_retry_count++;
+  if (s_retry_count > s_policy.max_retries) {
+    LOG_WARN("Max weather retries reached; giving up until next trigger");
+    s_pending_request = false;
+    s_retry_count = 0;
+    return;
+  }
+  counters_inc(COUNTER_RETRIES);
   int interval = backoff_interval_seconds(s_retry_count);
-  APP_LOG(APP_LOG_LEVEL_INFO, "Scheduling weather retry #1 in %d seconds", interval);
-  s_retry_timer = app_timer_register(interval * 1000, retry_timer_cb, NULL);
+  LOG_INFO("Scheduling weather retry #%d in %d seconds", s_retry_count, interval);
+  s_retry_timer = counted_timer_register(interval * 1000, retry_timer_cb);
 }
 
 /* Bluetooth callback: when we reconnect, attempt an immediate retry/send
    if a pending request was waiting. */
-static void weather_bt_handler(bool connected) {
+static void weather_bt_handler(bool connected, void *ctx) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
   if (connected && s_pending_request) {
-    // Attempt immediate send on reconnect. If it fails, schedule exponential-backoff retries.
-    DictionaryIterator *iter;
-    if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
-      dict_write_int8(iter, 100, 1);
-      dict_write_end(iter);
-      AppMessageResult res = app_message_outbox_send();
-      if (res == APP_MSG_OK) {
-        APP_LOG(APP_LOG_LEVEL_INFO, "Weather send succeeded on BT reconnect");
-        s_last_request = time(NULL);
-        s_pending_request = false;
-        s_retry_count = 0;
-        if (s_retry_timer) {
-          app_timer_cancel(s_retry_timer);
-          s_retry_timer = NULL;
-        }
-        return;
-      } else {
-        APP_LOG(APP_LOG_LEVEL_WARNING, "Weather send failed on reconnect: %d", (int)res);
-        /* fall through to schedule exponential retry */
-      }
-    } else {
-      APP_LOG(APP_LOG_LEVEL_WARNING, "app_message_outbox_begin failed on BT reconnect");
+    // Send now rather than waiting out the backoff timer
+    if (s_retry_timer) {
+      app_timer_cancel(s_retry_timer);
+      s_retry_timer = NULL;
     }
-    // Start retry sequence (will check BT again before attempting)
-    schedule_weather_retry();
+    request_send();
   }
 }
 
 /* Periodic polling state */
 static uint16_t s_periodic_interval_minutes = 0;
 static bool s_periodic_enabled = false;
+static int s_tick_handle = -1;
 
-static void weather_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+/* Adaptive polling policy. The interval passed to weather_start_periodic()
+   is the base; it is stretched while payloads stop changing, on low battery
+   and overnight, and pulled back toward a floor while values move quickly.
+   The dispatcher fires when the minute of the day is a multiple of the
+   interval, so an interval that does not divide a day leaves one short gap
+   at midnight. The policy keeps the request cooldown below the shortest
+   interval this can choose (see validate_policy), so a scheduled poll is
+   only skipped when an off-schedule request (BT reconnect, retry) went out
+   less than a cooldown before it. */
+static const int WEATHER_POLL_FLOOR_MINUTES = 10;
+static const int WEATHER_POLL_MAX_MINUTES = 120;
+/* With at least this many forecast slots ahead the watch can run on its
+   timeline, and polls only need to top it up. */
+static const int WEATHER_TIMELINE_LOW_WATER = 3;
+static const int WEATHER_POLL_TIMELINE_MINUTES = 360;
+static const int WEATHER_MAX_STABLE_STREAK = 3; /* base * (1 + streak), up to 4x */
+static const int WEATHER_LOW_BATTERY_PERCENT = 20;
+static const int WEATHER_CRITICAL_BATTERY_PERCENT = 10;
+static uint8_t s_stable_streak = 0; /* consecutive payloads with no change */
+static bool s_volatile = false;     /* last payload moved quickly */
+static uint16_t s_poll_interval = 0;
+static uint8_t s_poll_reason = WEATHER_POLL_REASON_BASE;
+
+/* Night is the span between sunset and sunrise. The stored sun times may be
+   from an earlier day, so compare times of day (UTC) rather than epochs.
+   Unknown sun times never count as night. */
+static bool is_night(time_t now) {
+  if (!s_data.sunrise || !s_data.sunset) return false;
+  int32_t rise = (int32_t)(s_data.sunrise % 86400);
+  int32_t set = (int32_t)(s_data.sunset % 86400);
+  int32_t t = (int32_t)(now % 86400);
+  if (rise < set) return t < rise || t >= set;
+  return t >= set && t < rise; /* daylight spans UTC midnight */
+}
+
+static void update_poll_interval(void) {
   if (!s_periodic_enabled || s_periodic_interval_minutes == 0) return;
-  if ((tick_time->tm_min % s_periodic_interval_minutes) == 0) {
-    // Use the module's request function which enforces cooldown
-    if (!weather_request()) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "weather_request skipped by cooldown (periodic)");
+  int interval = s_periodic_interval_minutes;
+  uint8_t reason = WEATHER_POLL_REASON_BASE;
+
+  if (s_volatile) {
+    interval /= 2;
+    reason |= WEATHER_POLL_REASON_VOLATILE;
+  } else {
+    if (s_stable_streak > 0) {
+      interval *= 1 + s_stable_streak;
+      reason |= WEATHER_POLL_REASON_STABLE;
+    }
+    BatteryChargeState battery = event_bus_battery();
+    if (!battery.is_charging && battery.charge_percent < WEATHER_CRITICAL_BATTERY_PERCENT) {
+      interval *= 4;
+      reason |= WEATHER_POLL_REASON_LOW_BATTERY;
+    } else if (!battery.is_charging && battery.charge_percent < WEATHER_LOW_BATTERY_PERCENT) {
+      interval *= 2;
+      reason |= WEATHER_POLL_REASON_LOW_BATTERY;
+    }
+    if (is_night(time(NULL))) {
+      interval *= 3;
+      reason |= WEATHER_POLL_REASON_NIGHT;
     }
   }
+  if (interval < WEATHER_POLL_FLOOR_MINUTES) interval = WEATHER_POLL_FLOOR_MINUTES;
+  if (!s_volatile && s_data.forecast_count >= WEATHER_TIMELINE_LOW_WATER) {
+    /* The local timeline covers the next hours; poll just to top it up */
+    interval = WEATHER_POLL_TIMELINE_MINUTES;
+    reason |= WEATHER_POLL_REASON_TIMELINE;
+  } else if (interval > WEATHER_POLL_MAX_MINUTES) {
+    interval = WEATHER_POLL_MAX_MINUTES;
+    reason |= WEATHER_POLL_REASON_CAPPED;
+  }
+
+  if (interval != s_poll_interval || reason != s_poll_reason) {
+    LOG_INFO("Weather poll interval %d min (reason 0x%02x)", interval, reason);
+    s_poll_interval = (uint16_t)interval;
+    s_poll_reason = reason;
+    tick_dispatch_set_period(s_tick_handle, s_poll_interval);
+  }
+}
+
+/* The low battery reason reads the bus's battery state, which the bus only
+   keeps current while someone listens; listening also re-evaluates the
+   interval when the level crosses a threshold rather than at the next poll */
+static void weather_battery_handler(BatteryChargeState state, void *ctx) {
+  update_poll_interval();
+}
+
+static void adapt_poll_after_payload(bool changed, bool volatile_change) {
+  s_volatile = volatile_change;
+  if (changed) {
+    s_stable_streak = 0;
+  } else if (s_stable_streak < WEATHER_MAX_STABLE_STREAK) {
+    s_stable_streak++;
+  }
+  update_poll_interval();
+}
+
+/* Only called by the tick dispatcher when the polling period is due. */
+static void weather_tick_handler(struct tm *tick_time, TimeUnits units_changed, void *ctx) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
+  if (!s_periodic_enabled || s_periodic_interval_minutes == 0) return;
+  // Use the module's request function which enforces cooldown
+  if (!weather_request()) {
+    LOG_DEBUG("weather_request skipped by cooldown (periodic)");
+  }
+  // Battery and day/night may have moved since the last payload
+  update_poll_interval();
+}
+
+static void startup_timer_cb(void *data) {
+  counters_inc(COUNTER_WEATHER_WAKEUPS);
+  s_startup_timer = NULL;
+  if (!weather_request()) {
+    LOG_INFO("weather_request skipped by cooldown (startup)");
+  }
+}
+
+/* Startup fast path. Face switches relaunch the app; when the last request
+   or update is younger than the poll interval the restored snapshot is good
+   enough, so only schedule the poll for the time that remains instead of
+   paying for a GPS fix and HTTP call right away. */
+static void start_first_poll(void) {
+  time_t now = time(NULL);
+  time_t last = (s_updated_at > s_last_request) ? s_updated_at : s_last_request;
+  int interval = s_poll_interval * 60;
+  int age = (int)(now - last);
+  if (last && age >= 0 && age < interval) {
+    int remaining = interval - age;
+    LOG_INFO("Startup fast path: last activity %ds ago, next poll in %ds", age, remaining);
+    if (s_startup_timer) app_timer_cancel(s_startup_timer);
+    s_startup_timer = counted_timer_register((uint32_t)remaining * 1000, startup_timer_cb);
+    s_startups.fast_path++;
+  } else {
+    // Nothing recent: force a request so UI gets fresh data
+    weather_force_request();
+    s_startups.forced++;
+  }
+  persist_write_data(PERSIST_KEY_WEATHER_STARTUPS, &s_startups, sizeof(s_startups));
 }
 
 void weather_start_periodic(uint16_t minutes) {
   if (minutes == 0) return;
   s_periodic_interval_minutes = minutes;
   if (!s_periodic_enabled) {
-    tick_timer_service_subscribe(MINUTE_UNIT, weather_tick_handler);
+    s_tick_handle = tick_dispatch_register(MINUTE_UNIT, minutes, weather_tick_handler, NULL);
+    if (s_tick_handle < 0) {
+      LOG_ERROR("No tick slot for weather polling");
+      return;
+    }
     s_periodic_enabled = true;
   }
-  // Immediately attempt a forced request so UI gets fresh data
-  weather_force_request();
+  s_poll_interval = 0;
+  update_poll_interval();
+  start_first_poll();
 }
 
 void weather_stop_periodic(void) {
   if (s_periodic_enabled) {
-    tick_timer_service_unsubscribe();
+    tick_dispatch_unregister(s_tick_handle);
+    s_tick_handle = -1;
     s_periodic_enabled = false;
     s_periodic_interval_minutes = 0;
+    s_poll_interval = 0;
+    s_poll_reason = WEATHER_POLL_REASON_BASE;
+  }
+}
+
+/* Policy floors and caps, see weather_policy_t */
+static const int WEATHER_POLICY_MIN_COOLDOWN = 60;
+static const int WEATHER_POLICY_MIN_RETRY_BASE = 10;
+static const int WEATHER_POLICY_MAX_RETRY_INTERVAL = 60 * 60;
+static const int WEATHER_POLICY_MAX_RETRIES = 16;
+
+/* Slack below the shortest poll interval for the cooldown: ticks come on
+   minute boundaries while the request they trigger may go out later */
+static const int WEATHER_POLICY_COOLDOWN_SLACK = 60;
+
+static int clamp_int(int v, int lo, int hi) {
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+/* The shortest interval update_poll_interval() picks for a base interval */
+static int shortest_poll_minutes(int poll_minutes) {
+  int minutes = poll_minutes / 2; /* volatile weather */
+  return minutes < WEATHER_POLL_FLOOR_MINUTES ? WEATHER_POLL_FLOOR_MINUTES : minutes;
+}
+
+static void validate_policy(weather_policy_t *p) {
+  p->poll_minutes = clamp_int(p->poll_minutes, WEATHER_POLL_FLOOR_MINUTES, WEATHER_POLL_MAX_MINUTES);
+  /* A cooldown as long as the poll interval would skip scheduled polls */
+  p->cooldown_seconds = clamp_int(p->cooldown_seconds, WEATHER_POLICY_MIN_COOLDOWN,
+                                  shortest_poll_minutes(p->poll_minutes) * 60 - WEATHER_POLICY_COOLDOWN_SLACK);
+  p->retry_max_seconds = clamp_int(p->retry_max_seconds, WEATHER_POLICY_MIN_RETRY_BASE, WEATHER_POLICY_MAX_RETRY_INTERVAL);
+  p->retry_base_seconds = clamp_int(p->retry_base_seconds, WEATHER_POLICY_MIN_RETRY_BASE, p->retry_max_seconds);
+  p->max_retries = clamp_int(p->max_retries, 1, WEATHER_POLICY_MAX_RETRIES);
+}
+
+static void load_policy(void) {
+  weather_policy_record_t rec;
+  if (persist_read_data(PERSIST_KEY_WEATHER_POLICY, &rec, sizeof(rec)) == (int)sizeof(rec) &&
+      rec.version == WEATHER_POLICY_VERSION) {
+    s_policy = rec.policy;
+    validate_policy(&s_policy);
+  }
+}
+
+const weather_policy_t *weather_get_policy(void) {
+  return &s_policy;
+}
+
+bool weather_set_policy(const weather_policy_t *policy) {
+  weather_policy_t p = *policy;
+  validate_policy(&p);
+  if (memcmp(&p, &s_policy, sizeof(p)) == 0) return false;
+  s_policy = p;
+  weather_policy_record_t rec = { .version = WEATHER_POLICY_VERSION, .policy = p };
+  if (persist_write_data(PERSIST_KEY_WEATHER_POLICY, &rec, sizeof(rec)) < 0) {
+    LOG_WARN("Failed to persist refresh policy");
+  }
+  LOG_INFO("Refresh policy: poll %d min, cooldown %ds, retry %d-%ds x%d", (int)p.poll_minutes,
+           (int)p.cooldown_seconds, (int)p.retry_base_seconds, (int)p.retry_max_seconds, (int)p.max_retries);
+  if (s_periodic_enabled) {
+    s_periodic_interval_minutes = p.poll_minutes;
+    update_poll_interval();
+  }
+  return true;
+}
+
+/* Policy keys of the message being routed, merged over the current policy
+   and applied once the whole message has been seen. */
+static weather_policy_t s_incoming_policy;
+static bool s_has_incoming_policy = false;
+
+static void policy_tuple_handler(const Tuple *t, void *ctx) {
+  if (!s_has_incoming_policy) {
+    s_incoming_policy = s_policy;
+    s_has_incoming_policy = true;
+  }
+  /* Clamp before narrowing so out-of-range values hit the caps, not wrap */
+  int32_t v = clamp_int(t->value->int32, 0, UINT16_MAX);
+  if (t->key == MESSAGE_KEY_POLL_MINUTES) {
+    s_incoming_policy.poll_minutes = v;
+  } else if (t->key == MESSAGE_KEY_REQUEST_COOLDOWN) {
+    s_incoming_policy.cooldown_seconds = v;
+  } else if (t->key == MESSAGE_KEY_RETRY_BASE) {
+    s_incoming_policy.retry_base_seconds = v;
+  } else if (t->key == MESSAGE_KEY_RETRY_MAX_INTERVAL) {
+    s_incoming_policy.retry_max_seconds = v;
+  } else if (t->key == MESSAGE_KEY_MAX_RETRIES) {
+    s_incoming_policy.max_retries = clamp_int(v, 0, UINT8_MAX);
   }
 }
 
+static void policy_inbox_done(void *ctx) {
+  if (!s_has_incoming_policy) return;
+  s_has_incoming_policy = false;
+  weather_set_policy(&s_incoming_policy);
+}
+
+uint16_t weather_get_poll_interval(void) {
+  return s_poll_interval;
+}
+
+uint8_t weather_get_poll_reason(void) {
+  return s_poll_reason;
+}
+
+const weather_startup_stats_t *weather_get_startup_stats(void) {
+  return &s_startups;
+}
+
 bool weather_is_periodic_enabled(void) {
   return s_periodic_enabled;
 }
@@ -331,8 +1185,8 @@ void weather_run_sample_test(void) {
   s_data.humidity = 58;
   s_data.min = 15;
   s_data.max = 24;
-  s_data.sunrise = time(NULL) - 3600; // 1 hour ago
-  s_data.sunset = time(NULL) + 3600 * 10; // in 10 hours
+  set_sun_time(&s_data.sunrise, s_data.sunrise_text, sizeof(s_data.sunrise_text), time(NULL) - 3600); // 1 hour ago
+  set_sun_time(&s_data.sunset, s_data.sunset_text, sizeof(s_data.sunset_text), time(NULL) + 3600 * 10); // in 10 hours
   s_data.sky_code = 1;
   strncpy(s_data.city, "Testville", sizeof(s_data.city));
   s_data.city[sizeof(s_data.city)-1] = '\0';
@@ -344,44 +1198,3 @@ void weather_run_sample_test(void) {
   s_data.glyph[sizeof(s_data.glyph)-1] = '\0';
   notify_if_needed();
 }
-
-/* Map OWM icon code string to a default glyph. This provides a place for the
-   user to customize glyphs for each OWM icon. Returns non-empty glyph string
-   if mapping exists, otherwise empty string. */
-static const char *map_icon_code_to_glyph(const char *icon_code) {
-  if (!icon_code || !icon_code[0]) return "";
-  /* Known OWM icon codes to support:
-     01d,02d,03d,04d,09d,10d,11d,13d,50d,
-     01n,02n,03n,04n,09n,10n,11n,13n,50n
-
-     Fill the `glyph` field in the table below with the WeatherIcons glyph
-     (UTF-8 string) you want for each code. Leave as "" to use procedural
-     drawing fallback or the companion-provided glyph.
-  */
-  static const struct { const char *code; const char *glyph; } map[] = {
-    { "01d", "" }, // clear sky day 
-    { "02d", "" }, // few clouds day 
-    { "03d", "" }, // scattered clouds day
-    { "04d", "" }, // broken clouds day
-    { "09d", "" }, // shower rain day 
-    { "10d", "" }, // rain day 
-    { "11d", "" }, // thunderstorm day 
-    { "13d", "" }, // snow day 
-    { "50d", "" }, // mist day 
-    { "01n", "" }, // clear sky night 
-    { "02n", "" }, // few clouds night 
-    { "03n", "" }, // scattered clouds night 
-    { "04n", "" }, // broken clouds night
-    { "09n", "" }, // shower rain night 
-    { "10n", "" }, // rain night 
-    { "11n", "" }, // thunderstorm night 
-    { "13n", "" }, // snow night 
-    { "50n", "" }, // mist night 
-    { NULL, NULL }
-  };
-
-  for (int i = 0; map[i].code; ++i) {
-    if (strcmp(icon_code, map[i].code) == 0) return map[i].glyph;
-  }
-  return "";
-}
@@ -3,6 +3,7 @@
  *
  * Responsibilities:
  *  - hold latest weather state (temp, min/max, humidity, sunrise/sunset, sky_code, city)
+ *  - compute sunrise/sunset locally (solar.h) from the companion's LOCATION
  *  - parse incoming AppMessage payloads for weather keys
  *  - request weather refresh via outbox
  *  - notify a registered callback on updates
@@ -12,6 +13,18 @@
 
 #include <pebble.h>
 
+/* Capacity of the forecast ring in weather_data_t. */
+#define WEATHER_FORECAST_SLOTS 8
+
+/* One forecast slot. `icon` indexes the shared OWM icon table (0xFF for
+ * none); see weather_icon_code(). */
+typedef struct {
+  time_t time;  /* start of the slot, UTC epoch */
+  int8_t temp;  /* degrees C */
+  uint8_t icon;
+  uint8_t pop;  /* precipitation chance, percent */
+} weather_forecast_slot_t;
+
 typedef struct {
   int temp;
   int humidity;
@@ -19,56 +32,199 @@ typedef struct {
   int max;
   time_t sunrise;
   time_t sunset;
+  char sunrise_text[6]; /* sunrise as local "HH:MM", "" if unknown */
+  char sunset_text[6];
   int sky_code; /* 0=clear,1=clouds,2=precip */
   char city[32];
   char glyph[8]; /* UTF-8 glyph string (null-terminated) from WeatherIcons font */
   char icon_code[4]; /* OWM icon code like '01d' or '04n' (3 chars + NUL) */
+  /* Upcoming forecast as a ring: forecast_count slots in time order starting
+   * at forecast[forecast_head], wrapping at WEATHER_FORECAST_SLOTS. */
+  weather_forecast_slot_t forecast[WEATHER_FORECAST_SLOTS];
+  uint8_t forecast_head;
+  uint8_t forecast_count;
 } weather_data_t;
 
+/* Packed weather payload, carried as one TUPLE_BYTE_ARRAY under the
+ * WEATHER_PACKED message key instead of one tuple per field. All multi-byte
+ * fields are little-endian. Version 1 layout:
+ *   [0]      version (WEATHER_PACKED_VERSION)
+ *   [1]      temperature, int8 degrees C
+ *   [2]      humidity, uint8 percent
+ *   [3]      min temperature, int8
+ *   [4]      max temperature, int8
+ *   [5..6]   sunrise, uint16 minutes past UTC midnight (WEATHER_PACKED_NO_TIME if unknown)
+ *   [7..8]   sunset, uint16 minutes past UTC midnight (WEATHER_PACKED_NO_TIME if unknown)
+ *            Companions that send LOCATION leave both at NO_TIME; the watch
+ *            then computes the sun times itself.
+ *   [9]      icon index into the shared OWM icon table (0xFF if none)
+ *   [10..13] 32-bit FNV-1a hash of the city name; the name itself is only
+ *            sent (as CITY) when it changes
+ * Newer versions may append fields; decoders ignore trailing bytes.
+ */
+#define WEATHER_PACKED_VERSION 1
+#define WEATHER_PACKED_V1_SIZE 14
+#define WEATHER_PACKED_NO_TIME 0xFFFF
+
+/* Delta update against the last packed record the watch acknowledged. Each
+ * refresh request carries SNAPSHOT_HASH, the FNV-1a hash of the packed
+ * record the watch currently holds (0 if none). When the companion still
+ * has that record it may answer with a WEATHER_DELTA byte array instead:
+ *   [0]      version (WEATHER_PACKED_VERSION)
+ *   [1..4]   base hash, must equal the watch's SNAPSHOT_HASH
+ *   [5..6]   uint16 mask; bit i set means byte i of the packed record changed
+ *   [7..]    new values of the changed bytes, in ascending bit order
+ * A zero mask means "unchanged". On a base mismatch the watch drops the delta
+ * and re-requests with hash 0, which forces a full record.
+ */
+#define WEATHER_DELTA_HEADER_SIZE 7
+
+/* Forecast, carried as a WEATHER_FORECAST byte array in the same AppMessage
+ * as the current conditions (full or delta). Little-endian:
+ *   [0]      version (WEATHER_FORECAST_VERSION)
+ *   [1]      slot count N (at most WEATHER_FORECAST_SLOTS are kept)
+ *   [2..5]   uint32 UTC epoch of the first slot
+ *   [6..7]   uint16 minutes between slots
+ *   [8..]    N x 3 bytes: int8 temperature, uint8 icon index, uint8 pop %
+ * The companion omits it from deltas when it has not changed.
+ */
+#define WEATHER_FORECAST_VERSION 1
+#define WEATHER_FORECAST_HEADER_SIZE 8
+
+/* Location the weather is for, carried as a LOCATION byte array only when it
+ * changes (the watch persists it). Little-endian:
+ *   [0..3]   int32 latitude, 1e-4 degrees, north positive
+ *   [4..7]   int32 longitude, 1e-4 degrees, east positive
+ * Sunrise/sunset are computed from it once a day (see solar.h) instead of
+ * travelling with every weather payload.
+ */
+#define WEATHER_LOCATION_SIZE 8
+
 typedef void (*weather_update_callback)(const weather_data_t *data, void *ctx);
 
 /* Initialize the weather module. Provide an optional callback that will be
- * invoked whenever parsed weather data changes. The module does not start any
- * background threads; it only reacts to calls to weather_handle_inbox().
+ * invoked whenever parsed weather data changes (and once immediately if a
+ * persisted snapshot was restored). The module does not start any
+ * background threads; it reacts to weather payloads (WEATHER_PACKED or the
+ * legacy per-key payload), request delivery and BT reconnects through the
+ * event bus, to a minute tick that moves the current conditions along the
+ * forecast timeline, and to a day tick that recomputes sunrise/sunset. The
+ * event bus and the tick dispatcher must be initialized first.
  */
 void weather_init(weather_update_callback cb, void *ctx);
 
 /* Deinitialize the weather module. */
 void weather_deinit(void);
 
-/* Handle an incoming AppMessage dictionary containing weather keys. Call this
- * from the global inbox handler to let the module parse relevant keys.
- */
-void weather_handle_inbox(DictionaryIterator *iter);
-
-/* Request a weather refresh via AppMessage outbox. This writes a small
- * request payload the companion recognizes.
- */
-/* Request a weather refresh. This function enforces an internal cooldown and
- * returns true if a request was actually sent, or false if skipped due to
- * cooldown. Use weather_force_request() to bypass the cooldown.
+/* Request a weather refresh from the companion via the AppMessage outbox,
+ * subject to the policy's cooldown. Returns true if a request was sent or
+ * the call merged into one already in flight (nothing is sent then), and
+ * false if the cooldown skipped it or the send failed (a retry is
+ * scheduled). Use weather_force_request() to bypass the cooldown.
  */
 bool weather_request(void);
 
 /* Force a weather request, ignoring any cooldown. */
 void weather_force_request(void);
 
+/* Requests share one pipeline: while a request is in flight (queued until a
+ * weather payload, an outbox failure or a response timeout) further calls to
+ * weather_request()/weather_force_request() merge into it instead of sending
+ * again. Delivery is tracked through the event bus's outbox callbacks.
+ */
+
+/* Refresh policy, set at runtime from the companion's settings page and
+ * persisted across launches. Values below their floor (poll 10 min,
+ * cooldown 60 s, retry base 10 s, one retry) are raised to it and values
+ * above their cap (poll 120 min, retry delay 1 h, 16 retries) lowered, so
+ * a bad setting cannot turn the radio into a busy loop. The cooldown stays
+ * a minute below the shortest adaptive interval (half the poll interval,
+ * at least 10 min) so it never refuses a scheduled poll.
+ */
+typedef struct {
+  uint16_t poll_minutes;       /* base interval of the adaptive poll */
+  uint16_t cooldown_seconds;   /* minimum gap between weather_request() sends */
+  uint16_t retry_base_seconds; /* first retry delay, doubled per attempt */
+  uint16_t retry_max_seconds;  /* cap on the retry delay */
+  uint8_t max_retries;         /* attempts before giving up until the next trigger */
+} weather_policy_t;
+
+/* The policy in force; defaults until one is set. */
+const weather_policy_t *weather_get_policy(void);
+
+/* Validate (see above), persist and apply a policy. A running periodic poll
+ * switches to the new base interval. Returns true if the policy changed.
+ * Also reachable from the companion through the POLL_MINUTES,
+ * REQUEST_COOLDOWN, RETRY_BASE, RETRY_MAX_INTERVAL and MAX_RETRIES keys;
+ * keys missing from a message keep their current value.
+ */
+bool weather_set_policy(const weather_policy_t *policy);
+
 /* Periodic polling control: start/stop periodic weather requests.
- * weather_start_periodic(minutes): subscribe to minute ticks and request
- * every `minutes` minutes (e.g. 20). Calling start will immediately
- * trigger a forced request. Passing 0 is a no-op.
+ * weather_start_periodic(minutes): register with the tick dispatcher and
+ * request every `minutes` minutes (normally the policy's poll_minutes). If the last request or update
+ * (persisted across launches) is younger than the current poll interval,
+ * start takes the fast path and schedules the first poll for the remaining
+ * time; otherwise it immediately triggers a forced request. Passing 0 is a
+ * no-op. tick_dispatch_init() must have been called first.
  */
 void weather_start_periodic(uint16_t minutes);
 void weather_stop_periodic(void);
 
+/* Launch counters persisted across app restarts: how often
+ * weather_start_periodic() took the startup fast path versus forcing a
+ * request.
+ */
+typedef struct {
+  uint32_t fast_path;
+  uint32_t forced;
+} weather_startup_stats_t;
+
+const weather_startup_stats_t *weather_get_startup_stats(void);
+
 /* Query whether periodic polling is enabled. */
 bool weather_is_periodic_enabled(void);
 
+/* Reasons behind the current adaptive poll interval (bitmask). */
+typedef enum {
+  WEATHER_POLL_REASON_BASE        = 0,      /* plain interval from weather_start_periodic() */
+  WEATHER_POLL_REASON_STABLE      = 1 << 0, /* recent payloads did not change */
+  WEATHER_POLL_REASON_LOW_BATTERY = 1 << 1, /* battery low and not charging */
+  WEATHER_POLL_REASON_NIGHT       = 1 << 2, /* between sunset and sunrise */
+  WEATHER_POLL_REASON_VOLATILE    = 1 << 3, /* values moving quickly; shortened */
+  WEATHER_POLL_REASON_CAPPED      = 1 << 4, /* clamped to the maximum interval */
+  WEATHER_POLL_REASON_TIMELINE    = 1 << 5, /* forecast timeline covers the next hours */
+} weather_poll_reason_t;
+
+/* Current adaptive poll interval in minutes (0 while polling is stopped) and
+ * the weather_poll_reason_t bits that produced it. The policy lengthens the
+ * base interval when payloads repeat, the battery is low or it is night, and
+ * shortens it toward a floor when values move quickly.
+ */
+uint16_t weather_get_poll_interval(void);
+uint8_t weather_get_poll_reason(void);
+
 /* Accessor for the current weather snapshot. The pointer is owned by the
- * module and remains valid until deinit or the next update.
+ * module and remains valid until deinit or the next update. Between polls
+ * temp/icon follow the forecast slot for the current time.
  */
 const weather_data_t *weather_get(void);
 
+/* The last good snapshot is persisted whenever it changes and restored by
+ * weather_init(), which invokes the update callback right away if one was
+ * found. weather_get_updated_at() returns when the data was last confirmed
+ * by the companion (0 if never); weather_is_stale() is true once that is
+ * older than the stale age (default 2 hours, see weather_set_stale_age()).
+ * Values taken from the forecast timeline count as fresh while a later slot
+ * is still pending, and otherwise age from the start of their slot.
+ */
+time_t weather_get_updated_at(void);
+bool weather_is_stale(void);
+void weather_set_stale_age(uint32_t seconds);
+
+/* OWM icon code ("01d", ...) for an icon index, or "" if none/unknown. */
+const char *weather_icon_code(uint8_t icon);
+
 /* Run a small sample test: populate the module with sample values and invoke
  * the update callback. Useful for unit-testing the UI without the companion.
  */
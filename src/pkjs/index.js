@@ -3,6 +3,7 @@
 
 var OWM_API_KEY = 'e4db77e05017ec2320666f2e2465dcca'; // <-- replace with your key
 var OWM_URL = 'https://api.openweathermap.org/data/2.5/weather';
+var OWM_FORECAST_URL = 'https://api.openweathermap.org/data/2.5/forecast';
 
 // === TEST_MODE FLAG ===
 // If the API key isn't set (placeholder), enable TEST_MODE. In TEST_MODE the
@@ -15,8 +16,9 @@ var TEST_MODE = (!OWM_API_KEY || OWM_API_KEY.indexOf('<') === 0);
 var OWM_LAT = null; // e.g. 40.7128
 var OWM_LON = null; // e.g. -74.0060
 
-// Helper: send message to watch
-function sendMessage(payload) {
+// Helper: send message to watch. `onSent`, if given, runs once the watch has
+// acknowledged the message.
+function sendMessage(payload, onSent) {
   if (!Pebble || !Pebble.sendAppMessage) return;
   // Debug: log each key/value pair with details about sky glyph/icon
   for (var key in payload) {
@@ -30,6 +32,7 @@ function sendMessage(payload) {
   }
   Pebble.sendAppMessage(payload, function() {
     console.log('Send successful');
+    if (onSent) onSent();
   }, function(e) {
     console.log('Send failed: ' + JSON.stringify(e));
   });
@@ -54,122 +57,533 @@ function ajaxHelper(url, cbSuccess, cbError) {
   xhr.send();
 }
 
-function fetchWeather(coords) {
-  var url = OWM_URL + '?lat=' + coords.latitude + '&lon=' + coords.longitude + '&units=metric&appid=' + OWM_API_KEY;
-  ajaxHelper(url, function(data) {
-    try {
-      var temp = Math.round(data.main.temp);
-      var humidity = Math.round(data.main.humidity);
-      var min = Math.round(data.main.temp_min);
-      var max = Math.round(data.main.temp_max);
-      var sunrise = data.sys.sunrise; // UNIX UTC
-      var sunset = data.sys.sunset;
-      // Safely extract the icon code from the OWM response. The JSON has
-      // data.weather as an array; take weather[0].icon when available.
-      var icon = (data.weather && data.weather[0] && data.weather[0].icon) ? data.weather[0].icon : null;
-      // Map of OWM icon -> WeatherIcons glyph. Only use this mapping; if the
-      // icon isn't present or not mapped, do not send a glyph.
-      var iconToGlyph = {
-        '01d': '', '02d': '', '03d': '', '04d': '', '09d': '', '10d': '', '11d': '', '13d': '', '50d': '',
-        '01n': '', '02n': '', '03n': '', '04n': '', '09n': '', '10n': '', '11n': '', '13n': '', '50n': ''
-      };
-      var skyGlyph = (icon && iconToGlyph[icon]) ? iconToGlyph[icon] : null;
-      var sendIconCode = icon ? icon : null;
-
-      // Use numeric message keys to avoid mapping issues at runtime.
-      var payload = {};
-      payload[10000] = temp;      // WEATHER_TEMP
-      payload[10001] = humidity;  // WEATHER_HUMIDITY
-      payload[10002] = min;       // WEATHER_MIN
-      payload[10003] = max;       // WEATHER_MAX
-      payload[10004] = sunrise;   // SUNRISE
-      payload[10005] = sunset;    // SUNSET
+// When true, weather goes to the watch as one packed byte array
+// (WEATHER_PACKED, layout documented in src/c/weather.h). Set to false to
+// fall back to the legacy one-key-per-field payload.
+var USE_PACKED_PAYLOAD = true;
+var WEATHER_PACKED_KEY = 10014;
+var WEATHER_PACKED_SIZE = 14;
+var SNAPSHOT_HASH_KEY = 10015;
+var WEATHER_DELTA_KEY = 10016;
+var WEATHER_FORECAST_KEY = 10017;
+var LOCATION_KEY = 10018;
+var MEMORY_REPORT_KEY = 10019;
+var LOG_DUMP_KEY = 10020;
+var COUNTERS_KEY = 10021;
+// DARK_MODE is index 12 of messageKeys; 10009 is BT_CONNECTED.
+var DARK_MODE_KEY = 10012;
+// Refresh policy keys, indices 22-26 of messageKeys
+var POLL_MINUTES_KEY = 10022;
+var REQUEST_COOLDOWN_KEY = 10023;
+var RETRY_BASE_KEY = 10024;
+var RETRY_MAX_INTERVAL_KEY = 10025;
+var MAX_RETRIES_KEY = 10026;
+var FORECAST_VERSION = 1;
+var FORECAST_SLOTS = 8; // must not exceed WEATHER_FORECAST_SLOTS in weather.h
+// CITY is index 13 of messageKeys in package.json (keys number from 10000).
+var CITY_KEY = 10013;
+var WEATHER_PACKED_VERSION = 1;
+var PACKED_NO_TIME = 0xFFFF;
+var PACKED_NO_ICON = 0xFF;
+
+// Map of OWM icon -> WeatherIcons glyph. Only use this mapping; if the
+// icon isn't present or not mapped, do not send a glyph.
+var iconToGlyph = {
+  '01d': '', '02d': '', '03d': '', '04d': '', '09d': '', '10d': '', '11d': '', '13d': '', '50d': '',
+  '01n': '', '02n': '', '03n': '', '04n': '', '09n': '', '10n': '', '11n': '', '13n': '', '50n': ''
+};
+// Icon byte of the packed payload. Order must match s_icon_map in
+// src/c/weather.c; append new codes at the end.
+var ICON_CODES = ['01d', '02d', '03d', '04d', '09d', '10d', '11d', '13d', '50d',
+                  '01n', '02n', '03n', '04n', '09n', '10n', '11n', '13n', '50n'];
+
+// Hash of the last city name sent this session. The packed record carries
+// only a hash, so the name itself is sent again only when it changes.
+var lastSentCityHash = null;
+
+// 32-bit FNV-1a over an array of byte values, matching fnv1a() in weather.c.
+function fnv1a(bytes) {
+  var h = 0x811c9dc5;
+  for (var i = 0; i < bytes.length; i++) {
+    h ^= bytes[i];
+    // h *= 16777619 (FNV prime), kept in 32 bits without Math.imul
+    h = (h + (h << 1) + (h << 4) + (h << 7) + (h << 8) + (h << 24)) >>> 0;
+  }
+  return h >>> 0;
+}
+
+// Hash of the city name's UTF-8 bytes, matching city_hash() in weather.c.
+function cityHash(str) {
+  var utf8 = unescape(encodeURIComponent(str || ''));
+  var bytes = [];
+  for (var i = 0; i < utf8.length; i++) bytes.push(utf8.charCodeAt(i));
+  return fnv1a(bytes);
+}
+
+function clampInt8(v) { return Math.max(-128, Math.min(127, v)); }
+
+function utcMinutes(epoch) {
+  if (!epoch) return PACKED_NO_TIME;
+  return Math.floor((epoch % 86400) / 60);
+}
+
+// The watch computes sunrise/sunset from LOCATION, so the packed record only
+// carries them when no location is known.
+function packWeather(w) {
+  var icon = w.icon ? ICON_CODES.indexOf(w.icon) : -1;
+  var rise = w.coords ? PACKED_NO_TIME : utcMinutes(w.sunrise);
+  var set = w.coords ? PACKED_NO_TIME : utcMinutes(w.sunset);
+  var hash = cityHash(w.city);
+  return [
+    WEATHER_PACKED_VERSION,
+    clampInt8(w.temp) & 0xFF,
+    Math.max(0, Math.min(255, w.humidity)),
+    clampInt8(w.min) & 0xFF,
+    clampInt8(w.max) & 0xFF,
+    rise & 0xFF, (rise >> 8) & 0xFF,
+    set & 0xFF, (set >> 8) & 0xFF,
+    icon >= 0 ? icon : PACKED_NO_ICON,
+    hash & 0xFF, (hash >>> 8) & 0xFF, (hash >>> 16) & 0xFF, (hash >>> 24) & 0xFF
+  ];
+}
+
+// WEATHER_FORECAST byte array (layout in src/c/weather.h): header, then
+// temperature / icon / precipitation chance per slot.
+function packForecast(slots) {
+  var base = slots.length ? slots[0].time : 0;
+  var step = slots.length > 1 ? Math.round((slots[1].time - slots[0].time) / 60) : 180;
+  var out = [FORECAST_VERSION, slots.length,
+             base & 0xFF, (base >>> 8) & 0xFF, (base >>> 16) & 0xFF, (base >>> 24) & 0xFF,
+             step & 0xFF, (step >> 8) & 0xFF];
+  for (var i = 0; i < slots.length; i++) {
+    var icon = slots[i].icon ? ICON_CODES.indexOf(slots[i].icon) : -1;
+    out.push(clampInt8(slots[i].temp) & 0xFF, icon >= 0 ? icon : PACKED_NO_ICON, Math.max(0, Math.min(100, slots[i].pop)));
+  }
+  return out;
+}
+
+// Legacy payload: numeric message keys to avoid mapping issues at runtime.
+function legacyPayload(w) {
+  var payload = {};
+  payload[10000] = w.temp;      // WEATHER_TEMP
+  payload[10001] = w.humidity;  // WEATHER_HUMIDITY
+  payload[10002] = w.min;       // WEATHER_MIN
+  payload[10003] = w.max;       // WEATHER_MAX
+  if (!w.coords) {
+    payload[10004] = w.sunrise; // SUNRISE
+    payload[10005] = w.sunset;  // SUNSET
+  }
   // Send the sky glyph only if it was explicitly chosen from the OWM icon code.
+  var skyGlyph = (w.icon && iconToGlyph[w.icon]) ? iconToGlyph[w.icon] : null;
   if (skyGlyph) payload[10007] = skyGlyph; // SKY_GLYPH (matches appinfo mapping)
   // Send the raw OWM icon code if available so the watch module can map it too.
-  if (typeof sendIconCode !== 'undefined' && sendIconCode) payload[10008] = sendIconCode; // SKY_ICON
-    // City name (if available)
-    if (data.name) payload[10011] = data.name;
-      sendMessage(payload);
+  if (w.icon) payload[10008] = w.icon; // SKY_ICON
+  // City name (if available)
+  if (w.city) payload[CITY_KEY] = w.city;
+  return payload;
+}
+
+// LOCATION byte array (layout in src/c/weather.h): latitude and longitude
+// in 1e-4 degrees.
+function packLocation(coords) {
+  var lat = Math.round(coords.latitude * 10000);
+  var lon = Math.round(coords.longitude * 10000);
+  return [lat & 0xFF, (lat >> 8) & 0xFF, (lat >> 16) & 0xFF, (lat >>> 24) & 0xFF,
+          lon & 0xFF, (lon >> 8) & 0xFF, (lon >> 16) & 0xFF, (lon >>> 24) & 0xFF];
+}
+
+// Location last sent this session; the watch persists it, so it is only
+// sent again when it moves.
+var lastSentLocation = null;
+
+// Full records go to watches without a snapshot (e.g. fresh installs), so
+// they always carry the location too.
+function addLocation(payload, w, always) {
+  if (!w.coords) return;
+  var packed = packLocation(w.coords);
+  if (always || packed.join(',') !== lastSentLocation) payload[LOCATION_KEY] = packed;
+}
+
+// Build a WEATHER_DELTA (layout in src/c/weather.h) patching `base` into
+// `next`. A zero mask with no bytes means "unchanged".
+function deltaRecord(base, next) {
+  var baseHash = fnv1a(base);
+  var mask = 0;
+  var bytes = [];
+  for (var i = 1; i < next.length; i++) {
+    if (base[i] !== next[i]) {
+      mask |= (1 << i);
+      bytes.push(next[i]);
+    }
+  }
+  return [WEATHER_PACKED_VERSION,
+          baseHash & 0xFF, (baseHash >>> 8) & 0xFF, (baseHash >>> 16) & 0xFF, (baseHash >>> 24) & 0xFF,
+          mask & 0xFF, (mask >> 8) & 0xFF].concat(bytes);
+}
+
+// Last packed record sent to the watch, kept across companion restarts so a
+// watch acknowledging it (SNAPSHOT_HASH) can be answered with a delta.
+function loadLastRecord() {
+  try {
+    var rec = JSON.parse(localStorage.getItem('weather_last_record'));
+    return (rec && rec.length === WEATHER_PACKED_SIZE) ? rec : null;
+  } catch (e) {
+    return null;
+  }
+}
+
+function saveLastRecord(rec) {
+  try { localStorage.setItem('weather_last_record', JSON.stringify(rec)); } catch (e) { }
+}
+
+// `ackHash` is the SNAPSHOT_HASH from the watch's request, or null when the
+// send was not triggered by a request (e.g. on ready).
+// The forecast rides in the same AppMessage as the current conditions. With
+// a delta it is only included when it differs from the last one the watch
+// acknowledged. Returns the hash to record once this message is acked, or
+// null when the payload carries no forecast.
+function addForecast(payload, w, always) {
+  if (!w.forecast || !w.forecast.length) return null;
+  var packed = packForecast(w.forecast);
+  var hash = fnv1a(packed);
+  var last = null;
+  try { last = localStorage.getItem('weather_last_forecast'); } catch (e) { }
+  if (!always && String(hash) === last) return null;
+  payload[WEATHER_FORECAST_KEY] = packed;
+  return hash;
+}
+
+function saveLastForecast(hash) {
+  if (hash === null) return;
+  try { localStorage.setItem('weather_last_forecast', String(hash)); } catch (e) { }
+}
+
+function sendWeather(w, ackHash) {
+  if (!USE_PACKED_PAYLOAD) {
+    var legacy = legacyPayload(w);
+    var legacyForecast = addForecast(legacy, w, true);
+    addLocation(legacy, w, true);
+    sendMessage(legacy, function() {
+      saveLastForecast(legacyForecast);
+      if (w.coords) lastSentLocation = packLocation(w.coords).join(',');
+    });
+    return;
+  }
+  var payload = {};
+  var record = packWeather(w);
+  var last = loadLastRecord();
+  if (last && ackHash && (ackHash >>> 0) === fnv1a(last)) {
+    payload[WEATHER_DELTA_KEY] = deltaRecord(last, record);
+  } else {
+    payload[WEATHER_PACKED_KEY] = record;
+  }
+  var forecastHash = addForecast(payload, w, !payload[WEATHER_DELTA_KEY]);
+  var hash = cityHash(w.city);
+  if (w.city && hash !== lastSentCityHash) payload[CITY_KEY] = w.city;
+  addLocation(payload, w, !payload[WEATHER_DELTA_KEY]);
+  // Only state the watch has acknowledged may serve as a delta base or
+  // suppress a resend; a dropped message leaves the previous values in place.
+  sendMessage(payload, function() {
+    saveLastRecord(record);
+    saveLastForecast(forecastHash);
+    lastSentCityHash = hash;
+    if (w.coords) lastSentLocation = packLocation(w.coords).join(',');
+  });
+}
+
+// Static snapshot used in TEST_MODE: fixed coordinates (the watch derives
+// sunrise/sunset from them) and a test OWM icon code (clear day -> '01d').
+function testWeather() {
+  var now = Math.floor(Date.now() / 1000);
+  var forecast = [];
+  for (var i = 0; i < FORECAST_SLOTS; i++) {
+    forecast.push({ time: now - (now % 10800) + 10800 * (i + 1), temp: 18 + (i % 4), icon: i < 4 ? '02d' : '10n', pop: i * 10 });
+  }
+  return { temp: 20, humidity: 50, min: 15, max: 22,
+           sunrise: now - 3600 * 6, sunset: now + 3600 * 6,
+           coords: { latitude: 40.7128, longitude: -74.0060 },
+           icon: '01d', city: 'Testville', forecast: forecast };
+}
+
+// === Response cache ===
+// Answers are cached per endpoint, ~1 km cell (coordinates rounded to 2
+// decimals) and time bucket, with TTLs following OWM's update cadence:
+// current conditions refresh roughly every 10 minutes, the 3-hourly
+// forecast far less often. The newest entry per endpoint lives in
+// localStorage so it also survives companion restarts; concurrent fetches of
+// the same key share one XHR.
+var OWM_ENDPOINTS = {
+  weather: { url: OWM_URL, ttl: 10 * 60 * 1000, query: '' },
+  // FORECAST_SLOTS 3-hour entries; keeps the response (and cache) small
+  forecast: { url: OWM_FORECAST_URL, ttl: 60 * 60 * 1000, query: '&cnt=8' }
+};
+var pendingFetches = {}; // cache key -> array of {ok, fail} waiting on one XHR
+
+function weatherCacheKey(endpoint, coords, now) {
+  return endpoint + ':' + Number(coords.latitude).toFixed(2) + ',' + Number(coords.longitude).toFixed(2) +
+         '@' + Math.floor(now / OWM_ENDPOINTS[endpoint].ttl);
+}
+
+function readWeatherCache(endpoint, key, now) {
+  try {
+    var entry = JSON.parse(localStorage.getItem('weather_cache_' + endpoint));
+    if (entry && entry.key === key && now - entry.fetchedAt < OWM_ENDPOINTS[endpoint].ttl) return entry.data;
+  } catch (e) { }
+  return null;
+}
+
+function writeWeatherCache(endpoint, key, now, data) {
+  try {
+    localStorage.setItem('weather_cache_' + endpoint, JSON.stringify({ key: key, fetchedAt: now, data: data }));
+  } catch (e) { }
+}
+
+// Get the OWM JSON of `endpoint` ('weather' or 'forecast') for `coords`,
+// from cache when fresh.
+function getWeatherData(endpoint, coords, cbSuccess, cbError) {
+  var now = Date.now();
+  var key = weatherCacheKey(endpoint, coords, now);
+  var cached = readWeatherCache(endpoint, key, now);
+  if (cached) {
+    console.log('Weather cache hit for ' + key);
+    cbSuccess(cached);
+    return;
+  }
+  if (pendingFetches[key]) {
+    console.log('Joining in-flight weather fetch for ' + key);
+    pendingFetches[key].push({ ok: cbSuccess, fail: cbError });
+    return;
+  }
+  pendingFetches[key] = [{ ok: cbSuccess, fail: cbError }];
+  var ep = OWM_ENDPOINTS[endpoint];
+  var url = ep.url + '?lat=' + coords.latitude + '&lon=' + coords.longitude + '&units=metric' + ep.query + '&appid=' + OWM_API_KEY;
+  ajaxHelper(url, function(data) {
+    var waiters = pendingFetches[key];
+    delete pendingFetches[key];
+    writeWeatherCache(endpoint, key, now, data);
+    for (var i = 0; i < waiters.length; i++) waiters[i].ok(data);
+  }, function(err) {
+    var waiters = pendingFetches[key];
+    delete pendingFetches[key];
+    for (var i = 0; i < waiters.length; i++) waiters[i].fail(err);
+  });
+}
+// === End response cache ===
+
+// Compact forecast slots from an OWM /forecast response.
+function forecastSlots(data) {
+  var slots = [];
+  var list = (data && data.list) ? data.list : [];
+  for (var i = 0; i < list.length && slots.length < FORECAST_SLOTS; i++) {
+    var e = list[i];
+    slots.push({
+      time: e.dt,
+      temp: Math.round(e.main.temp),
+      icon: (e.weather && e.weather[0]) ? e.weather[0].icon : null,
+      pop: Math.round((e.pop || 0) * 100)
+    });
+  }
+  return slots;
+}
+
+// Merge current conditions and (optional) forecast into one snapshot. With a
+// forecast, min/max span the next 24 hours instead of the current
+// observation's station extremes.
+function buildSnapshot(current, forecast, coords) {
+  // Safely extract the icon code from the OWM response. The JSON has
+  // data.weather as an array; take weather[0].icon when available.
+  var icon = (current.weather && current.weather[0] && current.weather[0].icon) ? current.weather[0].icon : null;
+  var w = {
+    temp: Math.round(current.main.temp),
+    humidity: Math.round(current.main.humidity),
+    min: Math.round(current.main.temp_min),
+    max: Math.round(current.main.temp_max),
+    sunrise: current.sys.sunrise, // UNIX UTC
+    sunset: current.sys.sunset,
+    icon: icon,
+    city: current.name || '',
+    coords: coords,
+    forecast: forecast ? forecastSlots(forecast) : []
+  };
+  if (w.forecast.length) {
+    w.min = w.max = w.temp;
+    for (var i = 0; i < w.forecast.length; i++) {
+      w.min = Math.min(w.min, w.forecast[i].temp);
+      w.max = Math.max(w.max, w.forecast[i].temp);
+    }
+  }
+  return w;
+}
+
+// Fetch current conditions and the forecast in parallel and send them to
+// the watch as one AppMessage. A failed forecast still sends the current
+// conditions.
+function fetchWeather(coords, ackHash) {
+  var current = null, forecast = null, pending = 2;
+  function done() {
+    if (--pending > 0) return;
+    if (!current) return;
+    try {
+      sendWeather(buildSnapshot(current, forecast, coords), ackHash);
     } catch (err) {
       console.log('Parse error: ' + err);
     }
-  }, function(err) {
+  }
+  getWeatherData('weather', coords, function(data) { current = data; done(); }, function(err) {
     console.log('Weather request failed: ' + err);
+    done();
+  });
+  getWeatherData('forecast', coords, function(data) { forecast = data; done(); }, function(err) {
+    console.log('Forecast request failed: ' + err);
+    done();
   });
 }
 
-function fetchAndSend() {
+// === Location manager ===
+// A GPS fix is the slowest and most power-hungry step of a refresh, so fixes
+// are coarse (no high accuracy), reused for up to LOCATION_MAX_AGE_MS, and
+// only replace the location weather is fetched for once the user has moved
+// more than LOCATION_MOVE_THRESHOLD_M. Keeping the coordinates stable also
+// keeps hitting the response cache above.
+var LOCATION_MAX_AGE_MS = 30 * 60 * 1000;
+var LOCATION_MOVE_THRESHOLD_M = 2000;
+var LOCATION_TIMEOUT_MS = 10000;
+
+function readLastLocation() {
+  try {
+    var loc = JSON.parse(localStorage.getItem('last_location'));
+    if (loc && typeof loc.latitude === 'number' && typeof loc.longitude === 'number') return loc;
+  } catch (e) { }
+  return null;
+}
+
+function writeLastLocation(loc) {
+  try { localStorage.setItem('last_location', JSON.stringify(loc)); } catch (e) { }
+}
+
+// Great-circle distance in metres (haversine).
+function distanceMeters(a, b) {
+  var R = 6371000;
+  var toRad = Math.PI / 180;
+  var dLat = (b.latitude - a.latitude) * toRad;
+  var dLon = (b.longitude - a.longitude) * toRad;
+  var h = Math.sin(dLat / 2) * Math.sin(dLat / 2) +
+          Math.cos(a.latitude * toRad) * Math.cos(b.latitude * toRad) *
+          Math.sin(dLon / 2) * Math.sin(dLon / 2);
+  return 2 * R * Math.asin(Math.min(1, Math.sqrt(h)));
+}
+
+// Resolve the coordinates to fetch weather for. Fixed OWM_LAT/OWM_LON win;
+// otherwise a recent enough stored fix is returned without touching GPS.
+function getLocation(cbSuccess, cbError) {
+  if (OWM_LAT !== null && OWM_LON !== null) {
+    cbSuccess({ latitude: OWM_LAT, longitude: OWM_LON });
+    return;
+  }
+  var last = readLastLocation();
+  if (last && Date.now() - last.fixedAt < LOCATION_MAX_AGE_MS) {
+    cbSuccess(last);
+    return;
+  }
   if (!navigator.geolocation) {
-    console.log('No geolocation');
+    if (last) cbSuccess(last); else cbError(new Error('No geolocation'));
     return;
   }
+  navigator.geolocation.getCurrentPosition(function(pos) {
+    var fix = { latitude: pos.coords.latitude, longitude: pos.coords.longitude, fixedAt: Date.now() };
+    if (last && distanceMeters(last, fix) < LOCATION_MOVE_THRESHOLD_M) {
+      // Not moved far enough to matter: keep the anchor, refresh its age
+      last.fixedAt = fix.fixedAt;
+      fix = last;
+    } else {
+      console.log('Location changed to ' + fix.latitude + ',' + fix.longitude);
+    }
+    writeLastLocation(fix);
+    cbSuccess(fix);
+  }, function(err) {
+    // A stale fix is still better than no weather at all
+    if (last) cbSuccess(last); else cbError(err);
+  }, { enableHighAccuracy: false, maximumAge: LOCATION_MAX_AGE_MS, timeout: LOCATION_TIMEOUT_MS });
+}
+// === End location manager ===
+
+function fetchAndSend(ackHash) {
   // === TEST_MODE BRANCH (fetchAndSend) ===
   if (TEST_MODE) {
     console.log('TEST_MODE: sending static sunrise/sunset payload');
-    // Static example: sunrise and sunset epoch values (UTC)
-    var now = Math.floor(Date.now() / 1000);
-    var payload = {};
-    payload[10000] = 20;
-    payload[10001] = 50;
-    payload[10002] = 15;
-    payload[10003] = 22;
-    payload[10004] = now - 3600 * 6;
-    payload[10005] = now + 3600 * 6;
-    // Include a test OWM icon code and its mapped glyph so the watch displays it
-    // in TEST_MODE (example: clear day -> '01d').
-  payload[10008] = '01d';
-  payload[10007] = '';
-  payload[10011] = "Testville";
-    sendMessage(payload);
+    sendWeather(testWeather(), ackHash);
     return;
   }
   // === END TEST_MODE BRANCH (fetchAndSend) ===
-  navigator.geolocation.getCurrentPosition(function(pos) {
-    fetchWeather(pos.coords);
+  getLocation(function(coords) {
+    fetchWeather(coords, ackHash);
   }, function(err) {
-    console.log('Geoloc error: ' + err.message);
-  }, {timeout: 10000});
+    console.log('Geoloc error: ' + (err && err.message));
+  });
 }
 
+// === Debug reports ===
+// When true, ask the watch for its memory checkpoints and performance
+// counters on ready and log them, and have it dump its log ring (builds with
+// --log-ring) to the app log.
+var DEBUG_REPORTS = false;
+var MEMORY_CHECKPOINTS = ['init', 'window_load', 'font_load', 'weather_update'];
+// counter_t order in src/c/counters.h; the redraw slots follow render_slot_t
+var COUNTER_NAMES = ['redraw_time', 'redraw_date', 'redraw_icon_glyph', 'redraw_icon_test',
+  'redraw_sky_glyph', 'redraw_temperature', 'redraw_humidity', 'redraw_minmax',
+  'redraw_sunrise', 'redraw_sunset', 'redraw_status', 'inbox_messages', 'inbox_bytes',
+  'outbox_sent', 'outbox_failed', 'retries', 'cooldown_skips', 'tick_wakeups',
+  'updates', 'update_ms', 'weather_requests', 'weather_timers', 'weather_wakeups',
+  'deltas_applied', 'delta_mismatches', 'requests_coalesced', 'response_timeouts'];
+
+function readU32(b, i) { return (b[i] | (b[i + 1] << 8) | (b[i + 2] << 16) | (b[i + 3] << 24)) >>> 0; }
+function readU16(b, i) { return b[i] | (b[i + 1] << 8); }
+
+// MEMORY_REPORT byte array, layout in src/c/mem_stats.h.
+function logMemoryReport(bytes) {
+  if (!bytes || bytes[0] !== 1) return;
+  for (var n = 0, i = 2; n < bytes[1] && i + 20 <= bytes.length; n++, i += 20) {
+    console.log('Memory ' + (MEMORY_CHECKPOINTS[n] || n) + ': used=' + readU32(bytes, i) +
+                ' free=' + readU32(bytes, i + 4) + ' used_max=' + readU32(bytes, i + 8) +
+                ' free_min=' + readU32(bytes, i + 12) + ' stack_max=' + readU16(bytes, i + 16) +
+                ' samples=' + readU16(bytes, i + 18));
+  }
+}
+
+// COUNTERS byte array, layout in src/c/counters.h.
+function logCounters(bytes) {
+  if (!bytes || bytes[0] !== 1) return;
+  var parts = [];
+  for (var n = 0, i = 6; n < bytes[1] && i + 4 <= bytes.length; n++, i += 4) {
+    parts.push((COUNTER_NAMES[n] || n) + '=' + readU32(bytes, i));
+  }
+  console.log('Counters since ' + new Date(readU32(bytes, 2) * 1000).toISOString() + ': ' + parts.join(' '));
+}
+
+function requestDebugReports() {
+  var payload = {};
+  payload[MEMORY_REPORT_KEY] = 1;
+  payload[LOG_DUMP_KEY] = 1;
+  payload[COUNTERS_KEY] = 1;
+  sendMessage(payload);
+}
+// === End debug reports ===
+
 Pebble.addEventListener('ready', function() {
   console.log('PKJS ready');
+  if (DEBUG_REPORTS) requestDebugReports();
   // === TEST_MODE BRANCH (ready) ===
   if (TEST_MODE) {
     console.log('TEST_MODE: sending immediate static payload on ready');
-    var now = Math.floor(Date.now() / 1000);
-    var payload = {};
-    payload[10000] = 20;
-    payload[10001] = 50;
-    payload[10002] = 15;
-    payload[10003] = 22;
-    payload[10004] = now - 3600 * 6;
-    payload[10005] = now + 3600 * 6;
-    // Include a test OWM icon code and glyph for ready/test mode as well.
-  payload[10008] = '01d';
-  payload[10007] = '';
-  payload[10011] = "Testville";
-    sendMessage(payload);
+    sendWeather(testWeather());
     return;
   }
   // === END TEST_MODE BRANCH (ready) ===
 
-  // Not in TEST_MODE: attempt an immediate live fetch on ready so the watch
-  // receives initial values promptly. Prefer fixed coords if present, else
-  // fall back to geolocation (which will prompt the phone for permission).
-  if (OWM_LAT !== null && OWM_LON !== null) {
-    console.log('Using fixed coords for initial fetch: ' + OWM_LAT + ',' + OWM_LON);
-    fetchWeather({ latitude: OWM_LAT, longitude: OWM_LON });
-  } else if (navigator.geolocation) {
-    console.log('Attempting geolocation for initial fetch');
-    navigator.geolocation.getCurrentPosition(function(pos) {
-      fetchWeather(pos.coords);
-    }, function(err) {
-      console.log('Geoloc error on ready: ' + err.message);
-    }, {timeout: 10000});
-  } else {
-    console.log('No geolocation available and no fixed coords; initial fetch skipped');
-  }
+  // Not in TEST_MODE: no fetch here. The watch sends REQUEST_WEATHER at
+  // launch unless its stored snapshot is still fresh (see start_first_poll
+  // in weather.c), so a face switch costs neither a location fix nor an
+  // OWM call when nothing is due.
 
   // On ready, also send current DARK_MODE setting if available from localStorage
   try {
@@ -177,7 +591,7 @@ Pebble.addEventListener('ready', function() {
     if (dark !== null) {
       var dm = (dark === '1') ? 1 : 0;
       var payload = {};
-      payload[10009] = dm; // DARK_MODE numeric key (10009)
+      payload[DARK_MODE_KEY] = dm;
       sendMessage(payload);
     }
   } catch (e) {
@@ -187,29 +601,101 @@ Pebble.addEventListener('ready', function() {
 
 Pebble.addEventListener('appmessage', function(e) {
   console.log('AppMessage received: ' + JSON.stringify(e.payload));
+  // Debug replies carry one or both reports and nothing else
+  if (e.payload && (e.payload[MEMORY_REPORT_KEY] !== undefined || e.payload[COUNTERS_KEY] !== undefined)) {
+    if (e.payload[MEMORY_REPORT_KEY] !== undefined) logMemoryReport(e.payload[MEMORY_REPORT_KEY]);
+    if (e.payload[COUNTERS_KEY] !== undefined) logCounters(e.payload[COUNTERS_KEY]);
+    return;
+  }
   // Support request from watch to refresh
   // Some messages may use numeric keys (e.g., 100) to request a refresh
   if (e.payload && (e.payload.REQUEST_WEATHER || e.payload['100'])) {
-    fetchAndSend();
+    // SNAPSHOT_HASH acknowledges the packed record the watch holds
+    var ack = e.payload[SNAPSHOT_HASH_KEY] !== undefined ? e.payload[SNAPSHOT_HASH_KEY] : e.payload.SNAPSHOT_HASH;
+    fetchAndSend(ack);
   }
 });
 
+// === Refresh policy ===
+// Mirrors weather_policy_t in src/c/weather.h. The watch clamps every value
+// to the same floors and caps; clamping here keeps the page honest about
+// what the watch will use.
+var POLICY_DEFAULTS = { poll: 20, cooldown: 540, retryBase: 30, retryMax: 600, retries: 8 };
+var POLICY_LIMITS = {
+  poll: [10, 120], cooldown: [60, 65535], retryBase: [10, 3600], retryMax: [10, 3600], retries: [1, 16]
+};
+
+function clampPolicy(p) {
+  var out = {};
+  for (var k in POLICY_DEFAULTS) {
+    var v = parseInt(p && p[k], 10);
+    if (isNaN(v)) v = POLICY_DEFAULTS[k];
+    out[k] = Math.min(Math.max(v, POLICY_LIMITS[k][0]), POLICY_LIMITS[k][1]);
+  }
+  if (out.retryBase > out.retryMax) out.retryBase = out.retryMax;
+  // As the watch clamps it: a minute below the shortest adaptive interval
+  var shortest = Math.max(10, Math.floor(out.poll / 2));
+  if (out.cooldown > shortest * 60 - 60) out.cooldown = shortest * 60 - 60;
+  return out;
+}
+
+function loadPolicy() {
+  try {
+    return clampPolicy(JSON.parse(localStorage.getItem('refresh_policy')));
+  } catch (e) {
+    return clampPolicy(null);
+  }
+}
+
+function addPolicy(payload, p) {
+  payload[POLL_MINUTES_KEY] = p.poll;
+  payload[REQUEST_COOLDOWN_KEY] = p.cooldown;
+  payload[RETRY_BASE_KEY] = p.retryBase;
+  payload[RETRY_MAX_INTERVAL_KEY] = p.retryMax;
+  payload[MAX_RETRIES_KEY] = p.retries;
+}
+
+// <select> with the given values (seconds or minutes) and display labels
+function policySelect(id, values, labels, cur) {
+  var html = '<select id="' + id + '">';
+  for (var i = 0; i < values.length; i++) {
+    html += '<option value="' + values[i] + '"' + (values[i] === cur ? ' selected' : '') + '>' + labels[i] + '</option>';
+  }
+  return html + '</select>';
+}
+// === End refresh policy ===
+
 // Settings: show a tiny HTML page (data URL) with a checkbox for dark mode
+// and the refresh policy
 Pebble.addEventListener('showConfiguration', function() {
   try {
     var cur = localStorage.getItem('dark_mode') || '1';
     var checked = (cur === '1') ? 'checked' : '';
+    var policy = loadPolicy();
     var html = '' +
       '<!doctype html><html><head><meta name="viewport" content="width=device-width, initial-scale=1">' +
       '<style>body{font-family:sans-serif;padding:16px;} label{display:block;margin:12px 0;}</style>' +
       '</head><body>' +
       '<h3>watchface1 Settings</h3>' +
       '<label><input id="dark" type="checkbox" ' + checked + '> Dark mode (black background, white text)</label>' +
+      '<h4>Weather refresh</h4>' +
+      '<label>Check every ' + policySelect('poll', [10, 15, 20, 30, 60, 120],
+        ['10 min', '15 min', '20 min', '30 min', '1 hour', '2 hours'], policy.poll) +
+      ' (longer saves battery)</label>' +
+      '<label>At most one request per ' + policySelect('cooldown', [60, 300, 540, 1200, 1800],
+        ['1 min', '5 min', '9 min', '20 min', '30 min'], policy.cooldown) + '</label>' +
+      '<label>First retry after ' + policySelect('retryBase', [10, 30, 60, 120],
+        ['10 s', '30 s', '1 min', '2 min'], policy.retryBase) + '</label>' +
+      '<label>Longest retry wait ' + policySelect('retryMax', [300, 600, 1800, 3600],
+        ['5 min', '10 min', '30 min', '1 hour'], policy.retryMax) + '</label>' +
+      '<label>Give up after <input id="retries" type="number" min="1" max="16" value="' + policy.retries + '"> retries</label>' +
       '<button id="save">Save</button>' +
       '<script>' +
+      'function v(id){ return document.getElementById(id).value; }' +
       'document.getElementById("save").addEventListener("click", function(){' +
       'var d = document.getElementById("dark").checked ? "1" : "0";' +
-      'var result = { D: d };' +
+      'var result = { D: d, P: { poll: v("poll"), cooldown: v("cooldown"), retryBase: v("retryBase"),' +
+      ' retryMax: v("retryMax"), retries: v("retries") } };' +
       'var uri = "pebblejs://close#" + encodeURIComponent(JSON.stringify(result));' +
       'window.location = uri;' +
       '});' +
@@ -226,15 +712,21 @@ Pebble.addEventListener('webviewclosed', function(e) {
   if (!e || !e.response) return;
   try {
     var data = JSON.parse(decodeURIComponent(e.response));
+    // Every setting goes to the watch in one AppMessage; a second send
+    // straight after the first would find the outbox busy.
+    var payload = {};
     if (data && data.D !== undefined) {
       var dm = (data.D === '1' || data.D === 1) ? 1 : 0;
       // Persist locally
       try { localStorage.setItem('dark_mode', dm ? '1' : '0'); } catch (ex) { }
-      // Send to watch using the DARK_MODE message key numeric mapping
-      var payload = {};
-  payload[10009] = dm; // DARK_MODE numeric key
-      sendMessage(payload);
+      payload[DARK_MODE_KEY] = dm;
+    }
+    if (data && data.P) {
+      var policy = clampPolicy(data.P);
+      try { localStorage.setItem('refresh_policy', JSON.stringify(policy)); } catch (ex) { }
+      addPolicy(payload, policy);
     }
+    if (Object.keys(payload).length) sendMessage(payload);
   } catch (err) {
     console.log('Config parse error: ' + err);
   }
@@ -0,0 +1,129 @@
+/* Inbox handling cost against tuple count. The same message is delivered
+   repeatedly at 1 to 20 tuples (about what the face's 256 byte inbox
+   holds), first to the message router alone (four ranges with counting
+   handlers, keys owned and unowned) and then to the running face (a packed
+   snapshot plus weather, status and unowned keys). For comparison, the
+   router's single pass is set against the dict_find() per key lookups the
+   inbox used before it (twelve keys). Prints host time per message and per
+   tuple. */
+
+#include <time.h>
+#include "check.h"
+#include "support.h"
+#include "counters.h"
+#include "event_bus.h"
+#include "msg_router.h"
+
+#define REPEATS 2000
+#define UNOWNED_KEY 9000
+
+static const int s_tuple_counts[] = { 1, 2, 4, 8, 16, 20 };
+#define TUPLE_COUNT_STEPS ((int)(sizeof(s_tuple_counts) / sizeof(s_tuple_counts[0])))
+
+static uint32_t s_tuples_handled = 0;
+static uint32_t s_done_calls = 0;
+
+static void count_tuple(const Tuple *t, void *ctx) {
+  s_tuples_handled++;
+}
+
+static void count_done(void *ctx) {
+  s_done_calls++;
+}
+
+static double ns_since(const struct timespec *start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec);
+}
+
+/* Delivers the message written last REPEATS times; ns per delivery */
+static double deliver_repeatedly(void) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < REPEATS; ++i) shim_inbox_deliver();
+  return ns_since(&start) / REPEATS;
+}
+
+static void bench_router(void) {
+  counters_init();
+  event_bus_init();
+  msg_router_init();
+  app_message_open(256, 64);
+  // Every other block of four keys is owned
+  CHECK(msg_router_register(10000, 10003, count_tuple, count_done, NULL));
+  CHECK(msg_router_register(10008, 10011, count_tuple, count_done, NULL));
+  CHECK(msg_router_register(10016, 10019, count_tuple, NULL, NULL));
+  CHECK(msg_router_register(10024, 10027, count_tuple, count_done, &s_done_calls));
+
+  printf("router alone:\n  %6s %12s %10s %18s\n", "tuples", "ns/message", "ns/tuple", "dict_find x12 ns");
+  for (int step = 0; step < TUPLE_COUNT_STEPS; ++step) {
+    int count = s_tuple_counts[step];
+    DictionaryIterator *iter = shim_inbox_begin();
+    for (int i = 0; i < count; ++i) dict_write_uint32(iter, 10000 + (uint32_t)i, (uint32_t)i);
+    s_tuples_handled = 0;
+    double ns = deliver_repeatedly();
+    int owned = 0;
+    for (int i = 0; i < count; ++i) owned += (i / 4) % 2 == 0;
+    CHECK_EQ(s_tuples_handled, (uint32_t)owned * REPEATS);
+
+    // The lookups the inbox did before the router, on the same message
+    DictionaryIterator read;
+    uint8_t copy[256];
+    uint32_t size = dict_write_end(iter);
+    memcpy(copy, iter->dictionary, size);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t found = 0;
+    for (int r = 0; r < REPEATS; ++r) {
+      dict_read_begin_from_buffer(&read, copy, (uint16_t)size);
+      for (uint32_t key = 10000; key < 10012; ++key) found += dict_find(&read, key) != NULL;
+    }
+    double find_ns = ns_since(&start) / REPEATS;
+    CHECK(found > 0);
+    printf("  %6d %12.0f %10.1f %18.0f\n", count, ns, ns / count, find_ns);
+  }
+  msg_router_deinit();
+}
+
+static void face_inbox(void) {
+  static const uint32_t *const filler_keys[] = {
+    &MESSAGE_KEY_WEATHER_TEMP, &MESSAGE_KEY_WEATHER_HUMIDITY, &MESSAGE_KEY_WEATHER_MIN,
+    &MESSAGE_KEY_WEATHER_MAX, &MESSAGE_KEY_BT_CONNECTED, NULL,
+  };
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 60, 10, 23, 0, "Berlin");
+  support_send_packed(record, "Berlin");
+  uint32_t inbox_before = counters_get(COUNTER_INBOX_MESSAGES);
+
+  printf("face:\n  %6s %12s %10s\n", "tuples", "ns/message", "ns/tuple");
+  uint32_t delivered = 0;
+  for (int step = 0; step < TUPLE_COUNT_STEPS; ++step) {
+    int count = s_tuple_counts[step];
+    DictionaryIterator *iter = shim_inbox_begin();
+    dict_write_data(iter, MESSAGE_KEY_WEATHER_PACKED, record, sizeof(record));
+    for (int i = 1; i < count; ++i) {
+      const uint32_t *key = filler_keys[i % (sizeof(filler_keys) / sizeof(filler_keys[0]))];
+      // Same values as the snapshot, so no pass changes what is shown
+      int32_t value = key == &MESSAGE_KEY_WEATHER_TEMP ? 21 : key == &MESSAGE_KEY_WEATHER_HUMIDITY ? 60
+                    : key == &MESSAGE_KEY_WEATHER_MIN ? 10 : key == &MESSAGE_KEY_WEATHER_MAX ? 23 : 1;
+      dict_write_int32(iter, key ? *key : UNOWNED_KEY, value);
+    }
+    double ns = deliver_repeatedly();
+    delivered += REPEATS;
+    printf("  %6d %12.0f %10.1f\n", count, ns, ns / count);
+  }
+  // None dropped: every message fit the face's inbox
+  CHECK_EQ(counters_get(COUNTER_INBOX_MESSAGES) - inbox_before, delivered);
+  CHECK(shim_text_shown("21°C"));
+}
+
+static void bench_face(void) {
+  CHECK(shim_run_app(face_inbox));
+}
+
+int main(void) {
+  RUN(bench_router);
+  RUN(bench_face);
+  return check_failures();
+}
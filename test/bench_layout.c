@@ -0,0 +1,83 @@
+/* Layout cost per face update: a week of hourly weather updates (the
+   temperature follows a daily curve, humidity drifts, min/max change daily)
+   delivered to the running face, each followed by a frame. Reports per
+   update the text measurements, frame and text changes, layers marked dirty
+   and text drawn, plus host time. Built twice, once per render backend
+   (bench_layout and bench_layout_canvas, see render.h). */
+
+#include <time.h>
+#include "check.h"
+#include "support.h"
+#include "render.h"
+
+#define DAYS 7
+#define UPDATES (DAYS * 24)
+
+static const int8_t s_temps[24] = {
+  12, 11, 11, 10, 10, 10, 11, 13, 15, 17, 19, 21, 22, 23, 23, 23, 22, 21, 19, 17, 15, 14, 13, 12,
+};
+
+static shim_stats_t s_cost;
+
+/* Adds what the shim counted since `before` to s_cost */
+static void add_cost(const shim_stats_t *before) {
+  const shim_stats_t *now = shim_stats();
+  s_cost.text_layout_calls += now->text_layout_calls - before->text_layout_calls;
+  s_cost.draw_text_calls += now->draw_text_calls - before->draw_text_calls;
+  s_cost.frame_sets += now->frame_sets - before->frame_sets;
+  s_cost.dirty_marks += now->dirty_marks - before->dirty_marks;
+  s_cost.text_sets += now->text_sets - before->text_sets;
+  s_cost.frames += now->frames - before->frames;
+}
+
+static void run_updates(void) {
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  // First snapshot and frame: layers get their text, not measured here
+  support_pack(record, s_temps[0], 60, 10, 23, 0, "Berlin");
+  support_send_packed(record, "Berlin");
+  shim_render();
+
+  // Only the update and its frame count; the minute ticks in between redraw
+  // the time and are left out
+  double ns = 0;
+  for (int i = 1; i <= UPDATES; ++i) {
+    int day = i / 24;
+    int hour = i % 24;
+    shim_advance(60 * 60);
+    shim_render();
+    support_pack(record, s_temps[hour] + day % 3, 55 + (i * 7) % 20, 10 + day % 3, 23 + day % 3,
+                 (hour >= 6 && hour < 21) ? 0 : 9, "Berlin");
+    shim_stats_t before = *shim_stats();
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    support_send_packed(record, NULL);
+    shim_render();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    add_cost(&before);
+  }
+  ns /= UPDATES;
+
+  const shim_stats_t *stats = &s_cost;
+  printf("layout (%s backend): %d updates\n", RENDER_CANVAS ? "canvas" : "text layer", UPDATES);
+  printf("  per update: %.2f text measurements, %.2f frame sets, %.2f text sets, %.2f dirty marks\n",
+         (double)stats->text_layout_calls / UPDATES, (double)stats->frame_sets / UPDATES,
+         (double)stats->text_sets / UPDATES, (double)stats->dirty_marks / UPDATES);
+  printf("  per update: %.2f frames, %.2f texts drawn\n", (double)stats->frames / UPDATES,
+         (double)stats->draw_text_calls / UPDATES);
+  printf("  host time %.0f ns per update\n", ns);
+
+  // At most one measurement per update, and only the temperature moves
+  CHECK(stats->text_layout_calls <= UPDATES);
+  CHECK(stats->frame_sets <= stats->text_layout_calls);
+  CHECK_EQ(stats->frames, UPDATES);
+}
+
+static void bench_layout_week(void) {
+  CHECK(shim_run_app(run_updates));
+}
+
+int main(void) {
+  RUN(bench_layout_week);
+  return check_failures();
+}
@@ -0,0 +1,145 @@
+/* Radio cost of a day: replays a scripted 24 hours of minute ticks, BT
+   drops, phone-side delivery failures, battery changes and changing weather
+   against the real face, with a fake phone answering every request, and
+   reports the outbox sends, timers and wakeups it took. The script and the
+   clock are fixed, so the figures only move when the code does; compare
+   them across releases. */
+
+#include "check.h"
+#include "support.h"
+#include "counters.h"
+
+typedef enum {
+  EV_BT,       /* arg: connected */
+  EV_BATTERY,  /* arg: percent, arg2: charging */
+  EV_FAILURES, /* arg: the phone fails this many deliveries */
+} event_type_t;
+
+typedef struct {
+  int minute; /* of the day, UTC (the shim's local time) */
+  event_type_t type;
+  int arg;
+  int arg2;
+} replay_event_t;
+
+static const replay_event_t s_script[] = {
+  { 2 * 60,       EV_BT, 0 },
+  { 2 * 60 + 45,  EV_BT, 1 },
+  { 7 * 60 + 30,  EV_FAILURES, 3 },
+  { 9 * 60,       EV_BATTERY, 45, 0 },
+  { 12 * 60,      EV_BT, 0 },
+  { 12 * 60 + 2,  EV_BT, 1 },
+  { 14 * 60,      EV_FAILURES, 2 },
+  { 16 * 60,      EV_BATTERY, 18, 0 },
+  { 18 * 60,      EV_BATTERY, 9, 0 },
+  { 19 * 60,      EV_BATTERY, 9, 1 },
+  { 21 * 60,      EV_BATTERY, 100, 1 },
+  { 22 * 60 + 30, EV_BT, 0 },
+  { 23 * 60 + 10, EV_BT, 1 },
+};
+#define SCRIPT_LENGTH ((int)(sizeof(s_script) / sizeof(s_script[0])))
+
+/* Hourly temperatures; the icon is clear sky by day and by night */
+static const int8_t s_temps[24] = {
+  12, 11, 11, 10, 10, 10, 11, 13, 15, 17, 19, 21, 22, 23, 23, 23, 22, 21, 19, 17, 15, 14, 13, 12,
+};
+
+/* Berlin, 1e-4 degrees, little-endian */
+static const uint8_t s_location[WEATHER_LOCATION_SIZE] = {
+  0x60, 0xE1, 0x07, 0x00, /* 52.5200 */
+  0x2A, 0x04, 0x02, 0x00, /* 13.4050 */
+};
+
+static uint8_t s_phone_record[WEATHER_PACKED_V1_SIZE];
+static int s_phone_failures = 0;
+static bool s_bt = true;
+
+/* The phone's side after every second of watch time */
+static void phone_step(int minute) {
+  if (!shim_outbox_pending(NULL)) return;
+  if (!s_bt) {
+    shim_outbox_nack(APP_MSG_NOT_CONNECTED);
+    return;
+  }
+  if (s_phone_failures > 0) {
+    s_phone_failures--;
+    shim_outbox_nack(APP_MSG_SEND_TIMEOUT);
+    return;
+  }
+  int hour = minute / 60 % 24;
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, s_temps[hour], 60, 10, 23, (hour >= 6 && hour < 21) ? 0 : 9, "Berlin");
+  bool first = s_phone_record[0] == 0;
+  if (support_phone_answer(s_phone_record, record) && first) {
+    DictionaryIterator *iter = shim_inbox_begin();
+    dict_write_cstring(iter, MESSAGE_KEY_CITY, "Berlin");
+    dict_write_data(iter, MESSAGE_KEY_LOCATION, s_location, sizeof(s_location));
+    shim_inbox_deliver();
+  }
+}
+
+static void replay_day(void) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  phone_step(0);
+  int next = 0;
+  for (int minute = 0; minute < 24 * 60; ++minute) {
+    for (; next < SCRIPT_LENGTH && s_script[next].minute == minute; ++next) {
+      const replay_event_t *ev = &s_script[next];
+      if (ev->type == EV_BT) {
+        s_bt = ev->arg;
+        shim_set_bt(s_bt);
+      } else if (ev->type == EV_BATTERY) {
+        shim_set_battery((uint8_t)ev->arg, ev->arg2);
+      } else {
+        s_phone_failures = ev->arg;
+      }
+    }
+    for (int second = 0; second < 60; ++second) {
+      shim_advance(1);
+      phone_step(minute);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double host_ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+
+  const shim_stats_t *stats = shim_stats();
+  printf("replay: scripted day, %d events\n", SCRIPT_LENGTH);
+  printf("  app_message_outbox_send  %5u  (weather requests %u, refused %u)\n",
+         (unsigned)stats->outbox_sends, (unsigned)counters_get(COUNTER_WEATHER_REQUESTS),
+         (unsigned)(stats->outbox_sends - shim_outbox_count()));
+  printf("  delivered / failed       %5u / %u\n", (unsigned)counters_get(COUNTER_OUTBOX_SENT),
+         (unsigned)counters_get(COUNTER_OUTBOX_FAILED));
+  printf("  AppTimer registrations   %5u  (weather %u)\n", (unsigned)stats->timers_registered,
+         (unsigned)counters_get(COUNTER_WEATHER_TIMERS));
+  printf("  wakeups                  %5u  (ticks %u, timers %u, weather %u)\n",
+         (unsigned)(stats->ticks_delivered + stats->timers_fired), (unsigned)stats->ticks_delivered,
+         (unsigned)stats->timers_fired, (unsigned)counters_get(COUNTER_WEATHER_WAKEUPS));
+  printf("  retries %u, timeouts %u, coalesced %u, cooldown skips %u\n",
+         (unsigned)counters_get(COUNTER_RETRIES), (unsigned)counters_get(COUNTER_RESPONSE_TIMEOUTS),
+         (unsigned)counters_get(COUNTER_REQUESTS_COALESCED), (unsigned)counters_get(COUNTER_COOLDOWN_SKIPS));
+  printf("  poll interval at midnight %u min (reason 0x%02x)\n", (unsigned)weather_get_poll_interval(),
+         (unsigned)weather_get_poll_reason());
+  printf("  host time %.1f ms\n", host_ms);
+
+  // One tick subscription for the whole face: a wakeup per minute, no more
+  CHECK_EQ(stats->ticks_delivered, 24 * 60);
+  // Polls never come faster than the 10 minute floor, plus the scripted
+  // failures' retries, and the day is covered at least at the 2 hour cap
+  uint32_t requests = counters_get(COUNTER_WEATHER_REQUESTS);
+  CHECK(requests <= 24 * 60 / 10 + counters_get(COUNTER_RETRIES));
+  CHECK(requests >= 24 / 2);
+  CHECK_EQ(counters_get(COUNTER_WEATHER_REQUESTS), shim_outbox_count());
+  CHECK_EQ(shim_log_count(APP_LOG_LEVEL_ERROR), counters_get(COUNTER_OUTBOX_FAILED));
+}
+
+static void bench_replay_day(void) {
+  shim_set_time(SHIM_DEFAULT_TIME - 12 * 60 * 60); // midnight
+  shim_set_battery(80, false);
+  CHECK(shim_run_app(replay_day));
+}
+
+int main(void) {
+  RUN(bench_replay_day);
+  return check_failures();
+}
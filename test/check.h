@@ -0,0 +1,71 @@
+/* check.h
+ * Minimal runner for the host tests.
+ *
+ * Each case is a void function run in a child process on a freshly booted
+ * watch (shim_boot()), so module statics and storage start clean and a
+ * failed CHECK (which exits) only ends its own case:
+ *
+ *   static void test_cooldown(void) { CHECK(!weather_request()); }
+ *   int main(void) { RUN(test_cooldown); return check_failures(); }
+ *
+ * Include this before any face header.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "pebble_shim.h"
+
+#define CHECK(cond) do { \
+  if (!(cond)) { \
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    exit(1); \
+  } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+  long long check_a_ = (long long)(a), check_b_ = (long long)(b); \
+  if (check_a_ != check_b_) { \
+    fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, \
+            check_a_, check_b_); \
+    exit(1); \
+  } \
+} while (0)
+
+#define CHECK_STR(a, b) do { \
+  const char *check_a_ = (a), *check_b_ = (b); \
+  if (strcmp(check_a_, check_b_) != 0) { \
+    fprintf(stderr, "%s:%d: CHECK_STR(%s, %s) failed: \"%s\" != \"%s\"\n", __FILE__, __LINE__, #a, #b, \
+            check_a_, check_b_); \
+    exit(1); \
+  } \
+} while (0)
+
+static int s_check_failures = 0;
+
+static void check_run(const char *name, void (*fn)(void)) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    shim_boot();
+    fn();
+    fflush(stdout);
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  printf("%s %s\n", ok ? "ok  " : "FAIL", name);
+  if (!ok) s_check_failures++;
+}
+
+#define RUN(fn) check_run(#fn, fn)
+
+static inline int check_failures(void) {
+  return s_check_failures ? 1 : 0;
+}
@@ -0,0 +1,314 @@
+/* pebble.h (host shim)
+ * The subset of the Pebble SDK the face uses, for building src/c on a
+ * Linux host.
+ *
+ * Types and constants follow the SDK headers, including a 32-bit time_t
+ * and the packed Tuple layout, so persisted structs and dictionaries have
+ * the same sizes as on the watch. The services behind the declarations are
+ * fakes (pebble_shim.c) that tests drive through pebble_shim.h: an
+ * advanceable clock with tick and timer delivery, in-memory persist, BT and
+ * battery state, a recording outbox and a layer tree that remembers what
+ * was drawn. The basalt platform is assumed.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Platform */
+#define PBL_PLATFORM_BASALT
+#define PBL_RECT
+#define PBL_COLOR
+
+/* Time: 32 bits as on the watch, read from the shim's clock */
+typedef time_t shim_host_time_t;
+typedef int32_t pbl_time_t;
+#define time_t pbl_time_t
+pbl_time_t shim_time(pbl_time_t *tloc);
+struct tm *shim_localtime(const pbl_time_t *timep);
+#define time(t) shim_time(t)
+#define localtime(t) shim_localtime(t)
+
+uint16_t time_ms(time_t *t_utc, uint16_t *out_ms);
+bool clock_is_24h_style(void);
+
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+/* Logging */
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, args...) app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+/* Dictionaries */
+typedef enum {
+  DICT_OK = 0,
+  DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+  DICT_INVALID_ARGS = 1 << 2,
+} DictionaryResult;
+
+typedef enum {
+  TUPLE_BYTE_ARRAY = 0,
+  TUPLE_CSTRING = 1,
+  TUPLE_UINT = 2,
+  TUPLE_INT = 3,
+} TupleType;
+
+typedef struct __attribute__((__packed__)) {
+  uint32_t key;
+  TupleType type:8;
+  uint16_t length;
+  union {
+    uint8_t data[0];
+    char cstring[0];
+    uint8_t uint8;
+    uint16_t uint16;
+    uint32_t uint32;
+    int8_t int8;
+    int16_t int16;
+    int32_t int32;
+  } value[];
+} Tuple;
+
+typedef struct __attribute__((__packed__)) Dictionary {
+  uint8_t count;
+  Tuple head[];
+} Dictionary;
+
+typedef struct {
+  Dictionary *dictionary;
+  const void *end;
+  Tuple *cursor;
+} DictionaryIterator;
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *buffer, uint16_t size);
+DictionaryResult dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size);
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, uint32_t key, const char *cstring);
+DictionaryResult dict_write_int8(DictionaryIterator *iter, uint32_t key, int8_t value);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, uint32_t key, int32_t value);
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, uint32_t key, uint32_t value);
+uint32_t dict_write_end(DictionaryIterator *iter);
+Tuple *dict_read_begin_from_buffer(DictionaryIterator *iter, const uint8_t *buffer, uint16_t size);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+Tuple *dict_find(const DictionaryIterator *iter, uint32_t key);
+uint32_t dict_size(DictionaryIterator *iter);
+
+/* AppMessage */
+typedef enum {
+  APP_MSG_OK = 0,
+  APP_MSG_SEND_TIMEOUT = 1 << 1,
+  APP_MSG_SEND_REJECTED = 1 << 2,
+  APP_MSG_NOT_CONNECTED = 1 << 3,
+  APP_MSG_APP_NOT_RUNNING = 1 << 4,
+  APP_MSG_INVALID_ARGS = 1 << 5,
+  APP_MSG_BUSY = 1 << 6,
+  APP_MSG_BUFFER_OVERFLOW = 1 << 7,
+  APP_MSG_ALREADY_RELEASED = 1 << 9,
+  APP_MSG_CALLBACK_ALREADY_REGISTERED = 1 << 10,
+  APP_MSG_CALLBACK_NOT_REGISTERED = 1 << 11,
+  APP_MSG_OUT_OF_MEMORY = 1 << 12,
+  APP_MSG_CLOSED = 1 << 13,
+  APP_MSG_INTERNAL_ERROR = 1 << 14,
+} AppMessageResult;
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void *context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iterator, AppMessageResult reason, void *context);
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+void app_message_deregister_callbacks(void);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+
+/* Timers */
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+/* Persistent storage */
+#define PERSIST_DATA_MAX_LENGTH 256
+#define E_DOES_NOT_EXIST (-10)
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int persist_delete(const uint32_t key);
+
+/* Connection and battery */
+typedef void (*BluetoothConnectionHandler)(bool connected);
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler);
+void bluetooth_connection_service_unsubscribe(void);
+bool bluetooth_connection_service_peek(void);
+
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+/* Memory */
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+/* Trigonometry */
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+/* Geometry and color */
+typedef struct { int16_t x; int16_t y; } GPoint;
+typedef struct { int16_t w; int16_t h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b);
+
+typedef union GColor8 {
+  uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorClear ((GColor8){.argb = 0x00})
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+/* Resources and fonts */
+typedef struct ResHandle_ *ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle h);
+
+/* RESOURCE_ID_* of the basalt build, generated from package.json */
+#include "resource_ids.auto.h"
+
+typedef struct FontInfo *GFont;
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_ROBOTO_CONDENSED_21 "RESOURCE_ID_ROBOTO_CONDENSED_21"
+#define FONT_KEY_ROBOTO_BOLD_SUBSET_49 "RESOURCE_ID_ROBOTO_BOLD_SUBSET_49"
+GFont fonts_get_system_font(const char *font_key);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+/* Graphics */
+typedef struct GContext GContext;
+typedef struct GTextAttributes GTextAttributes;
+typedef enum {
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+typedef enum {
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont const font, const GRect box,
+                                            const GTextOverflowMode overflow_mode,
+                                            const GTextAlignment alignment);
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+
+/* Layers */
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+typedef struct TextLayer TextLayer;
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode);
+
+/* Windows and buttons */
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+Layer *window_get_root_layer(const Window *window);
+void window_set_background_color(Window *window, GColor background_color);
+void window_stack_push(Window *window, bool animated);
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+typedef enum {
+  BUTTON_ID_BACK = 0,
+  BUTTON_ID_UP,
+  BUTTON_ID_SELECT,
+  BUTTON_ID_DOWN,
+  NUM_BUTTONS
+} ButtonId;
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+
+/* App */
+void app_event_loop(void);
@@ -0,0 +1,1015 @@
+/* Fake Pebble services behind shim/pebble.h; controls in pebble_shim.h. */
+
+#include <stdarg.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "pebble_shim.h"
+
+/* Generated from package.json with resource_ids.auto.h: the resource name
+   of each basalt resource id (index 0 unused). */
+extern const char *const shim_resource_names[];
+extern const int shim_resource_name_count;
+
+#define MAX_TIMERS 32
+#define MAX_LAYERS 64
+#define MAX_PERSIST 32
+#define MAX_RECORDED 256
+#define MESSAGE_MAX 512
+
+/* What outlives a launch: storage and the clock. It lives in memory shared
+   with the launches' processes (see shim_run_app). */
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  uint16_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} persist_entry_t;
+
+typedef struct {
+  uint64_t now_ms;
+  persist_entry_t persist[MAX_PERSIST];
+  uint32_t persist_writes;
+} shared_state_t;
+
+static shared_state_t *s_shared;
+
+/* A fresh mapping, so storage written before is not seen either */
+__attribute__((constructor)) void shim_boot(void) {
+  s_shared = mmap(NULL, sizeof(*s_shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (s_shared == MAP_FAILED) abort();
+  s_shared->now_ms = (uint64_t)SHIM_DEFAULT_TIME * 1000;
+}
+
+/* Clock */
+
+pbl_time_t shim_time(pbl_time_t *tloc) {
+  pbl_time_t now = (pbl_time_t)(s_shared->now_ms / 1000);
+  if (tloc) *tloc = now;
+  return now;
+}
+
+/* Local time is UTC on the host, so runs don't depend on the machine's zone */
+struct tm *shim_localtime(const pbl_time_t *timep) {
+  static struct tm tm;
+  shim_host_time_t t = *timep;
+  return gmtime_r(&t, &tm);
+}
+
+uint16_t time_ms(pbl_time_t *t_utc, uint16_t *out_ms) {
+  uint16_t ms = (uint16_t)(s_shared->now_ms % 1000);
+  if (t_utc) *t_utc = (pbl_time_t)(s_shared->now_ms / 1000);
+  if (out_ms) *out_ms = ms;
+  return ms;
+}
+
+bool clock_is_24h_style(void) {
+  return true;
+}
+
+/* Stats and logging */
+
+static shim_stats_t s_stats;
+static uint32_t s_log_counts[256];
+
+const shim_stats_t *shim_stats(void) {
+  return &s_stats;
+}
+
+void shim_reset_stats(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  s_log_counts[log_level]++;
+  if (!getenv("SHIM_LOG")) return;
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%u] %s:%d ", (unsigned)log_level, src_filename, src_line_number);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+uint32_t shim_log_count(AppLogLevel level) {
+  return s_log_counts[level & 0xFF];
+}
+
+/* Heap model: objects the SDK allocates on the app heap are charged at
+   roughly their basalt sizes. */
+
+#define HEAP_WINDOW 124
+#define HEAP_LAYER 44
+#define HEAP_TEXT_LAYER 88
+#define HEAP_FONT_BASE 160 /* font header */
+#define HEAP_FONT_PER_PX 24 /* glyph cache, scaled by line height */
+
+static size_t s_heap_used = 0;
+
+static void *heap_alloc(size_t size, size_t charge) {
+  void *p = calloc(1, size);
+  if (p) s_heap_used += charge;
+  return p;
+}
+
+static void heap_free(void *p, size_t charge) {
+  if (!p) return;
+  free(p);
+  s_heap_used -= charge;
+}
+
+size_t heap_bytes_used(void) {
+  return s_heap_used;
+}
+
+size_t heap_bytes_free(void) {
+  return SHIM_HEAP_SIZE - s_heap_used;
+}
+
+/* Dictionaries, in the SDK's wire layout */
+
+#define TUPLE_HEADER_SIZE (sizeof(Tuple))
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *buffer, uint16_t size) {
+  if (!iter || !buffer || size < sizeof(Dictionary)) return DICT_INVALID_ARGS;
+  iter->dictionary = (Dictionary *)buffer;
+  iter->dictionary->count = 0;
+  iter->cursor = iter->dictionary->head;
+  iter->end = buffer + size;
+  return DICT_OK;
+}
+
+static DictionaryResult write_tuple(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                    const void *data, uint16_t length) {
+  if (!iter || !iter->dictionary) return DICT_INVALID_ARGS;
+  uint8_t *at = (uint8_t *)iter->cursor;
+  if (at + TUPLE_HEADER_SIZE + length > (const uint8_t *)iter->end) return DICT_NOT_ENOUGH_STORAGE;
+  Tuple *t = iter->cursor;
+  t->key = key;
+  t->type = type;
+  t->length = length;
+  if (length) memcpy(t->value->data, data, length);
+  iter->cursor = (Tuple *)(at + TUPLE_HEADER_SIZE + length);
+  iter->dictionary->count++;
+  return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size) {
+  return write_tuple(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, uint32_t key, const char *cstring) {
+  return write_tuple(iter, key, TUPLE_CSTRING, cstring, cstring ? (uint16_t)(strlen(cstring) + 1) : 0);
+}
+
+DictionaryResult dict_write_int8(DictionaryIterator *iter, uint32_t key, int8_t value) {
+  return write_tuple(iter, key, TUPLE_INT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value) {
+  return write_tuple(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, uint32_t key, int32_t value) {
+  return write_tuple(iter, key, TUPLE_INT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, uint32_t key, uint32_t value) {
+  return write_tuple(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+  if (!iter || !iter->dictionary) return 0;
+  iter->end = iter->cursor;
+  return (uint32_t)((const uint8_t *)iter->end - (const uint8_t *)iter->dictionary);
+}
+
+Tuple *dict_read_begin_from_buffer(DictionaryIterator *iter, const uint8_t *buffer, uint16_t size) {
+  if (!iter || !buffer || size < sizeof(Dictionary)) return NULL;
+  iter->dictionary = (Dictionary *)buffer;
+  iter->end = buffer + size;
+  return dict_read_first(iter);
+}
+
+/* The tuple at the cursor, or NULL past the last one */
+static Tuple *tuple_at_cursor(DictionaryIterator *iter, int index) {
+  if (index >= iter->dictionary->count) return NULL;
+  const uint8_t *at = (const uint8_t *)iter->cursor;
+  if (at + TUPLE_HEADER_SIZE > (const uint8_t *)iter->end) return NULL;
+  if (at + TUPLE_HEADER_SIZE + iter->cursor->length > (const uint8_t *)iter->end) return NULL;
+  return iter->cursor;
+}
+
+static int tuple_index(DictionaryIterator *iter) {
+  int index = 0;
+  for (const uint8_t *at = (const uint8_t *)iter->dictionary->head; at < (const uint8_t *)iter->cursor;
+       at += TUPLE_HEADER_SIZE + ((const Tuple *)at)->length) {
+    index++;
+  }
+  return index;
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  if (!iter || !iter->dictionary) return NULL;
+  iter->cursor = iter->dictionary->head;
+  return tuple_at_cursor(iter, 0);
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  if (!iter || !iter->dictionary || !iter->cursor) return NULL;
+  iter->cursor = (Tuple *)((uint8_t *)iter->cursor + TUPLE_HEADER_SIZE + iter->cursor->length);
+  return tuple_at_cursor(iter, tuple_index(iter));
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, uint32_t key) {
+  if (!iter || !iter->dictionary) return NULL;
+  DictionaryIterator it = *iter;
+  for (Tuple *t = dict_read_first(&it); t; t = dict_read_next(&it)) {
+    if (t->key == key) return t;
+  }
+  return NULL;
+}
+
+uint32_t dict_size(DictionaryIterator *iter) {
+  if (!iter || !iter->dictionary) return 0;
+  return (uint32_t)((const uint8_t *)iter->end - (const uint8_t *)iter->dictionary);
+}
+
+/* AppMessage */
+
+static struct {
+  bool open;
+  uint32_t inbound_size;
+  uint32_t outbound_size;
+  AppMessageInboxReceived received;
+  AppMessageInboxDropped dropped;
+  AppMessageOutboxSent sent;
+  AppMessageOutboxFailed failed;
+  /* outbox */
+  uint8_t out_buf[MESSAGE_MAX];
+  DictionaryIterator out_iter;
+  bool out_begun;
+  bool out_pending;
+  uint16_t out_size;
+  AppMessageResult fail_next;
+  /* inbox */
+  uint8_t in_buf[MESSAGE_MAX];
+  DictionaryIterator in_iter;
+} s_msg;
+
+typedef struct {
+  uint16_t size;
+  uint8_t data[MESSAGE_MAX];
+} recorded_message_t;
+
+static recorded_message_t s_recorded[MAX_RECORDED];
+static int s_recorded_count = 0;
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  if (s_msg.open) return APP_MSG_INVALID_ARGS;
+  if (size_inbound > MESSAGE_MAX || size_outbound > MESSAGE_MAX) return APP_MSG_OUT_OF_MEMORY;
+  s_msg.open = true;
+  s_msg.inbound_size = size_inbound;
+  s_msg.outbound_size = size_outbound;
+  return APP_MSG_OK;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  AppMessageInboxReceived old = s_msg.received;
+  s_msg.received = received_callback;
+  return old;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+  AppMessageInboxDropped old = s_msg.dropped;
+  s_msg.dropped = dropped_callback;
+  return old;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+  AppMessageOutboxSent old = s_msg.sent;
+  s_msg.sent = sent_callback;
+  return old;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+  AppMessageOutboxFailed old = s_msg.failed;
+  s_msg.failed = failed_callback;
+  return old;
+}
+
+void app_message_deregister_callbacks(void) {
+  s_msg.received = NULL;
+  s_msg.dropped = NULL;
+  s_msg.sent = NULL;
+  s_msg.failed = NULL;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  if (!iterator || !s_msg.open) return APP_MSG_INVALID_ARGS;
+  if (s_msg.out_pending || s_msg.out_begun) return APP_MSG_BUSY;
+  dict_write_begin(&s_msg.out_iter, s_msg.out_buf, (uint16_t)s_msg.outbound_size);
+  s_msg.out_begun = true;
+  *iterator = &s_msg.out_iter;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  s_stats.outbox_sends++;
+  if (!s_msg.out_begun) return APP_MSG_INVALID_ARGS;
+  s_msg.out_begun = false;
+  if (s_msg.fail_next != APP_MSG_OK) {
+    AppMessageResult res = s_msg.fail_next;
+    s_msg.fail_next = APP_MSG_OK;
+    return res;
+  }
+  s_msg.out_size = (uint16_t)dict_write_end(&s_msg.out_iter);
+  s_msg.out_pending = true;
+  if (s_recorded_count < MAX_RECORDED) {
+    recorded_message_t *rec = &s_recorded[s_recorded_count];
+    rec->size = s_msg.out_size;
+    memcpy(rec->data, s_msg.out_buf, s_msg.out_size);
+  }
+  s_recorded_count++;
+  return APP_MSG_OK;
+}
+
+bool shim_outbox_pending(DictionaryIterator *out) {
+  if (!s_msg.out_pending) return false;
+  if (out) dict_read_begin_from_buffer(out, s_msg.out_buf, s_msg.out_size);
+  return true;
+}
+
+void shim_outbox_ack(void) {
+  if (!s_msg.out_pending) return;
+  s_msg.out_pending = false;
+  DictionaryIterator iter;
+  dict_read_begin_from_buffer(&iter, s_msg.out_buf, s_msg.out_size);
+  if (s_msg.sent) s_msg.sent(&iter, NULL);
+}
+
+void shim_outbox_nack(AppMessageResult reason) {
+  if (!s_msg.out_pending) return;
+  s_msg.out_pending = false;
+  DictionaryIterator iter;
+  dict_read_begin_from_buffer(&iter, s_msg.out_buf, s_msg.out_size);
+  if (s_msg.failed) s_msg.failed(&iter, reason, NULL);
+}
+
+void shim_outbox_fail_next(AppMessageResult result) {
+  s_msg.fail_next = result;
+}
+
+int shim_outbox_count(void) {
+  return s_recorded_count;
+}
+
+bool shim_outbox_message(int index, DictionaryIterator *out) {
+  if (index < 0 || index >= s_recorded_count || index >= MAX_RECORDED) return false;
+  dict_read_begin_from_buffer(out, s_recorded[index].data, s_recorded[index].size);
+  return true;
+}
+
+DictionaryIterator *shim_inbox_begin(void) {
+  dict_write_begin(&s_msg.in_iter, s_msg.in_buf, sizeof(s_msg.in_buf));
+  return &s_msg.in_iter;
+}
+
+void shim_inbox_deliver(void) {
+  uint32_t size = dict_write_end(&s_msg.in_iter);
+  if (!s_msg.open || size > s_msg.inbound_size) {
+    if (s_msg.dropped) s_msg.dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+    return;
+  }
+  DictionaryIterator iter;
+  dict_read_begin_from_buffer(&iter, s_msg.in_buf, (uint16_t)size);
+  if (s_msg.received) s_msg.received(&iter, NULL);
+}
+
+/* Timers */
+
+struct AppTimer {
+  bool used;
+  uint64_t due_ms;
+  uint32_t seq; /* registration order, to fire equal deadlines in order */
+  AppTimerCallback callback;
+  void *data;
+};
+
+static AppTimer s_timers[MAX_TIMERS];
+static uint32_t s_timer_seq = 0;
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  s_stats.timers_registered++;
+  for (int i = 0; i < MAX_TIMERS; ++i) {
+    if (s_timers[i].used) continue;
+    s_timers[i] = (AppTimer) {
+      .used = true,
+      .due_ms = s_shared->now_ms + timeout_ms,
+      .seq = s_timer_seq++,
+      .callback = callback,
+      .data = callback_data,
+    };
+    return &s_timers[i];
+  }
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  if (!timer_handle || !timer_handle->used) return false;
+  timer_handle->due_ms = s_shared->now_ms + new_timeout_ms;
+  timer_handle->seq = s_timer_seq++;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) timer_handle->used = false;
+}
+
+static AppTimer *next_timer(void) {
+  AppTimer *next = NULL;
+  for (int i = 0; i < MAX_TIMERS; ++i) {
+    AppTimer *t = &s_timers[i];
+    if (!t->used) continue;
+    if (!next || t->due_ms < next->due_ms || (t->due_ms == next->due_ms && t->seq < next->seq)) next = t;
+  }
+  return next;
+}
+
+/* Tick service. Ticks are delivered at minute boundaries only; the face
+   never asks for seconds. */
+
+static TimeUnits s_tick_units = 0;
+static TickHandler s_tick_handler = NULL;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_units = 0;
+  s_tick_handler = NULL;
+}
+
+static void deliver_tick(void) {
+  pbl_time_t now = (pbl_time_t)(s_shared->now_ms / 1000);
+  struct tm *tm = shim_localtime(&now);
+  TimeUnits changed = SECOND_UNIT | MINUTE_UNIT;
+  if (tm->tm_min == 0) {
+    changed |= HOUR_UNIT;
+    if (tm->tm_hour == 0) {
+      changed |= DAY_UNIT;
+      if (tm->tm_mday == 1) changed |= MONTH_UNIT;
+      if (tm->tm_yday == 0) changed |= YEAR_UNIT;
+    }
+  }
+  if (!s_tick_handler || !(changed & s_tick_units)) return;
+  s_stats.ticks_delivered++;
+  struct tm tick_time = *tm;
+  s_tick_handler(&tick_time, changed);
+}
+
+void shim_set_time(pbl_time_t utc) {
+  s_shared->now_ms = (uint64_t)utc * 1000;
+}
+
+void shim_advance_ms(uint64_t ms) {
+  uint64_t target = s_shared->now_ms + ms;
+  for (;;) {
+    AppTimer *timer = next_timer();
+    uint64_t tick_at = (s_shared->now_ms / 60000 + 1) * 60000;
+    bool timer_due = timer && timer->due_ms <= target;
+    bool tick_due = s_tick_handler && tick_at <= target;
+    if (!timer_due && !tick_due) break;
+    if (timer_due && (!tick_due || timer->due_ms <= tick_at)) {
+      if (timer->due_ms > s_shared->now_ms) s_shared->now_ms = timer->due_ms;
+      timer->used = false;
+      s_stats.timers_fired++;
+      timer->callback(timer->data);
+    } else {
+      s_shared->now_ms = tick_at;
+      deliver_tick();
+    }
+  }
+  s_shared->now_ms = target;
+}
+
+void shim_advance(uint32_t seconds) {
+  shim_advance_ms((uint64_t)seconds * 1000);
+}
+
+/* Persistent storage */
+
+static persist_entry_t *persist_find(uint32_t key) {
+  for (int i = 0; i < MAX_PERSIST; ++i) {
+    if (s_shared->persist[i].used && s_shared->persist[i].key == key) return &s_shared->persist[i];
+  }
+  return NULL;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+  persist_entry_t *e = persist_find(key);
+  return e ? e->size : E_DOES_NOT_EXIST;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  persist_entry_t *e = persist_find(key);
+  if (!e) return E_DOES_NOT_EXIST;
+  size_t n = e->size < buffer_size ? e->size : buffer_size;
+  memcpy(buffer, e->data, n);
+  return (int)n;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  if (persist_read_data(key, &value, sizeof(value)) != (int)sizeof(value)) return 0;
+  return value;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  persist_entry_t *e = persist_find(key);
+  for (int i = 0; !e && i < MAX_PERSIST; ++i) {
+    if (!s_shared->persist[i].used) e = &s_shared->persist[i];
+  }
+  if (!e) return -1;
+  size_t n = size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH;
+  e->used = true;
+  e->key = key;
+  e->size = (uint16_t)n;
+  memcpy(e->data, data, n);
+  s_shared->persist_writes++;
+  return (int)n;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_delete(const uint32_t key) {
+  persist_entry_t *e = persist_find(key);
+  if (!e) return E_DOES_NOT_EXIST;
+  e->used = false;
+  return 0;
+}
+
+uint32_t shim_persist_writes(void) {
+  return s_shared->persist_writes;
+}
+
+/* Connection and battery */
+
+static bool s_bt_connected = true;
+static BluetoothConnectionHandler s_bt_handler = NULL;
+static BatteryChargeState s_battery = { .charge_percent = 80 };
+static BatteryStateHandler s_battery_handler = NULL;
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) {
+  s_bt_handler = handler;
+}
+
+void bluetooth_connection_service_unsubscribe(void) {
+  s_bt_handler = NULL;
+}
+
+bool bluetooth_connection_service_peek(void) {
+  return s_bt_connected;
+}
+
+void shim_set_bt(bool connected) {
+  s_bt_connected = connected;
+  if (s_bt_handler) s_bt_handler(connected);
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery;
+}
+
+void shim_set_battery(uint8_t charge_percent, bool is_charging) {
+  s_battery = (BatteryChargeState) {
+    .charge_percent = charge_percent,
+    .is_charging = is_charging,
+    .is_plugged = is_charging,
+  };
+  if (s_battery_handler) s_battery_handler(s_battery);
+}
+
+/* Trigonometry, through libm at the SDK's fixed-point scales */
+
+static const double TWO_PI = 6.283185307179586;
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * TWO_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * TWO_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+  double a = atan2(y, x);
+  if (a < 0) a += TWO_PI;
+  return (int32_t)lround(a * TRIG_MAX_ANGLE / TWO_PI) % TRIG_MAX_ANGLE;
+}
+
+/* Geometry and color */
+
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b) {
+  return rect_a->origin.x == rect_b->origin.x && rect_a->origin.y == rect_b->origin.y &&
+         rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+  return x.argb == y.argb;
+}
+
+/* Resources and fonts. Text is measured with a fixed advance per character
+   derived from the font's pixel size, which is enough to tell which layout
+   work an update does. */
+
+struct FontInfo {
+  int height;
+  bool custom;
+};
+
+static struct FontInfo s_system_fonts[8];
+static const char *s_system_font_keys[8];
+
+/* Trailing pixel size of a font or resource name ("GOTHIC_18_BOLD" -> 18) */
+static int font_height(const char *name) {
+  int height = 0;
+  for (const char *p = name; *p; ++p) {
+    if (*p >= '0' && *p <= '9' && (p == name || p[-1] == '_')) height = atoi(p);
+  }
+  return height ? height : 14;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+  if (resource_id == 0 || (int)resource_id >= shim_resource_name_count) return NULL;
+  return (ResHandle)(uintptr_t)resource_id;
+}
+
+size_t resource_size(ResHandle h) {
+  return h ? (size_t)(HEAP_FONT_BASE + font_height(shim_resource_names[(uintptr_t)h]) * HEAP_FONT_PER_PX) : 0;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+  for (int i = 0; i < 8; ++i) {
+    if (s_system_font_keys[i] && strcmp(s_system_font_keys[i], font_key) == 0) return &s_system_fonts[i];
+    if (!s_system_font_keys[i]) {
+      s_system_font_keys[i] = font_key;
+      s_system_fonts[i] = (struct FontInfo) { .height = font_height(font_key) };
+      return &s_system_fonts[i];
+    }
+  }
+  return &s_system_fonts[0];
+}
+
+static size_t font_charge(int height) {
+  return HEAP_FONT_BASE + (size_t)height * HEAP_FONT_PER_PX;
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+  if (!handle) return NULL;
+  int height = font_height(shim_resource_names[(uintptr_t)handle]);
+  GFont font = heap_alloc(sizeof(struct FontInfo), font_charge(height));
+  if (font) *font = (struct FontInfo) { .height = height, .custom = true };
+  return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+  if (font) heap_free(font, font_charge(font->height));
+}
+
+/* Characters of UTF-8 text */
+static int utf8_length(const char *text) {
+  int n = 0;
+  for (const unsigned char *p = (const unsigned char *)text; *p; ++p) {
+    if ((*p & 0xC0) != 0x80) n++;
+  }
+  return n;
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont const font, const GRect box,
+                                            const GTextOverflowMode overflow_mode,
+                                            const GTextAlignment alignment) {
+  s_stats.text_layout_calls++;
+  int height = font ? font->height : 14;
+  int w = utf8_length(text ? text : "") * (height / 2 + 1);
+  int h = height + height / 4;
+  return GSize(w < box.size.w ? w : box.size.w, h < box.size.h ? h : box.size.h);
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+  s_stats.draw_text_calls++;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+}
+
+/* Layers */
+
+struct Layer {
+  GRect frame;
+  bool hidden;
+  bool dirty;
+  bool is_text; /* first member of a TextLayer */
+  LayerUpdateProc update_proc;
+  Layer *parent;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+  GFont font;
+  GColor text_color;
+  GColor background_color;
+  GTextAlignment alignment;
+  GTextOverflowMode overflow;
+};
+
+struct Window {
+  Layer *root;
+  WindowHandlers handlers;
+  GColor background_color;
+  bool loaded;
+  ClickConfigProvider click_config_provider;
+};
+
+static Layer *s_layers[MAX_LAYERS];     /* live layers, including text layers' */
+static TextLayer *s_text_layers[MAX_LAYERS]; /* live text layers in creation order */
+static int s_text_layer_count = 0;
+static Window *s_top_window = NULL;
+static ClickHandler s_click_handlers[NUM_BUTTONS];
+
+static void track_layer(Layer *layer) {
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    if (!s_layers[i]) {
+      s_layers[i] = layer;
+      return;
+    }
+  }
+}
+
+static void untrack_layer(Layer *layer) {
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    if (s_layers[i] == layer) s_layers[i] = NULL;
+  }
+}
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = heap_alloc(sizeof(Layer), HEAP_LAYER);
+  layer->frame = frame;
+  layer->dirty = true;
+  track_layer(layer);
+  return layer;
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) return;
+  untrack_layer(layer);
+  heap_free(layer, HEAP_LAYER);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  s_stats.dirty_marks++;
+  layer->dirty = true;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  child->parent = parent;
+  layer_mark_dirty(child);
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  s_stats.frame_sets++;
+  layer->frame = frame;
+  layer_mark_dirty(layer);
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden == hidden) return;
+  layer->hidden = hidden;
+  layer_mark_dirty(layer);
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = heap_alloc(sizeof(TextLayer), HEAP_TEXT_LAYER);
+  text_layer->layer.frame = frame;
+  text_layer->layer.dirty = true;
+  text_layer->layer.is_text = true;
+  text_layer->text_color = GColorBlack;
+  text_layer->background_color = GColorWhite;
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  track_layer(&text_layer->layer);
+  if (s_text_layer_count < MAX_LAYERS) s_text_layers[s_text_layer_count++] = text_layer;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (!text_layer) return;
+  untrack_layer(&text_layer->layer);
+  for (int i = 0; i < s_text_layer_count; ++i) {
+    if (s_text_layers[i] != text_layer) continue;
+    memmove(&s_text_layers[i], &s_text_layers[i + 1], (s_text_layer_count - i - 1) * sizeof(s_text_layers[0]));
+    s_text_layer_count--;
+    break;
+  }
+  heap_free(text_layer, HEAP_TEXT_LAYER);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  s_stats.text_sets++;
+  text_layer->text = text;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->background_color = color;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+  text_layer->alignment = text_alignment;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+  text_layer->overflow = line_mode;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+int shim_text_layer_count(void) {
+  return s_text_layer_count;
+}
+
+TextLayer *shim_text_layer(int index) {
+  return (index >= 0 && index < s_text_layer_count) ? s_text_layers[index] : NULL;
+}
+
+const char *shim_text_layer_text(const TextLayer *text_layer) {
+  return (text_layer && text_layer->text) ? text_layer->text : "";
+}
+
+bool shim_text_shown(const char *text) {
+  for (int i = 0; i < s_text_layer_count; ++i) {
+    const TextLayer *tl = s_text_layers[i];
+    if (!tl->layer.hidden && tl->text && strcmp(tl->text, text) == 0) return true;
+  }
+  return false;
+}
+
+/* A frame. As on the watch, any dirty layer redraws the whole window: every
+   visible layer's update proc runs and every visible text layer draws its
+   text. */
+void shim_render(void) {
+  bool dirty = false;
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    if (s_layers[i] && s_layers[i]->dirty) dirty = true;
+  }
+  if (!dirty) return;
+  s_stats.frames++;
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    Layer *layer = s_layers[i];
+    if (!layer) continue;
+    layer->dirty = false;
+    if (layer->hidden) continue;
+    if (layer->update_proc) layer->update_proc(layer, NULL);
+    if (layer->is_text) {
+      const TextLayer *tl = (const TextLayer *)layer;
+      if (tl->text && tl->text[0]) s_stats.draw_text_calls++;
+    }
+  }
+}
+
+int shim_live_layers(void) {
+  int n = 0;
+  for (int i = 0; i < MAX_LAYERS; ++i) n += s_layers[i] != NULL;
+  return n;
+}
+
+/* Windows and buttons. The root layer is basalt's 144x168 screen. */
+
+Window *window_create(void) {
+  Window *window = heap_alloc(sizeof(Window), HEAP_WINDOW);
+  window->root = layer_create(GRect(0, 0, 144, 168));
+  window->background_color = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) return;
+  if (window->loaded && window->handlers.unload) window->handlers.unload(window);
+  if (s_top_window == window) s_top_window = NULL;
+  layer_destroy(window->root);
+  heap_free(window, HEAP_WINDOW);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return window->root;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+  layer_mark_dirty(window->root);
+}
+
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (!window->loaded) {
+    window->loaded = true;
+    if (window->handlers.load) window->handlers.load(window);
+  }
+  if (window->handlers.appear) window->handlers.appear(window);
+}
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider) {
+  window->click_config_provider = click_config_provider;
+  memset(s_click_handlers, 0, sizeof(s_click_handlers));
+  if (click_config_provider) click_config_provider(window);
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+  if (button_id < NUM_BUTTONS) s_click_handlers[button_id] = handler;
+}
+
+void shim_click(ButtonId button) {
+  if (button < NUM_BUTTONS && s_click_handlers[button]) s_click_handlers[button](NULL, s_top_window);
+}
+
+/* App */
+
+static void (*s_event_loop)(void) = NULL;
+
+void app_event_loop(void) {
+  if (s_event_loop) s_event_loop();
+}
+
+bool shim_run_app(void (*loop)(void)) {
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    s_event_loop = loop;
+    watchface_main();
+    int layers = shim_live_layers();
+    if (layers || s_heap_used) {
+      fprintf(stderr, "app exit: %d layers and %zu heap bytes not freed\n", layers, s_heap_used);
+      exit(1);
+    }
+    exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
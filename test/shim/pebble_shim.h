@@ -0,0 +1,108 @@
+/* pebble_shim.h
+ * Test-side controls of the host shim (see pebble.h in this directory).
+ *
+ * A test drives the real face through watchface_main(), which is main() of
+ * src/c/watchface1.c renamed for the host build. shim_run_app() launches
+ * the app: init, then the test's event loop, then deinit. Within the loop
+ * the test plays the system's part:
+ *
+ *   shim_advance(60 * 60);           // an hour: timers and ticks in order
+ *   shim_set_bt(false);              // BT drop, through the subscribed handler
+ *   DictionaryIterator *it = shim_inbox_begin();
+ *   dict_write_int32(it, MESSAGE_KEY_WEATHER_TEMP, 21);
+ *   shim_inbox_deliver();            // the companion's reply
+ *   shim_outbox_ack();               // the phone took the pending message
+ *
+ * Each launch runs in a process of its own, so module statics start from
+ * their initializers as they do on the watch; only persistent storage and
+ * the clock carry over to the next launch. Test cases likewise run in
+ * processes of their own on a freshly booted watch (see check.h), so a case
+ * that calls the modules directly starts clean too.
+ */
+
+#pragma once
+
+#include <pebble.h>
+
+/* Clock the shim starts at: 2026-06-21 12:00 UTC, a Sunday. */
+#define SHIM_DEFAULT_TIME 1782043200
+
+/* Modeled app heap (bytes), see heap_bytes_free(). */
+#define SHIM_HEAP_SIZE (64 * 1024)
+
+/* The app's main(), renamed for the host build. */
+int watchface_main(void);
+
+/* A freshly booted watch: empty storage and the clock at
+ * SHIM_DEFAULT_TIME. check.h boots one for every case. */
+void shim_boot(void);
+
+/* Launch the app with `loop` as its event loop. Returns false if the
+ * launch failed a CHECK or did not free every layer and heap byte by the
+ * time deinit returned. */
+bool shim_run_app(void (*loop)(void));
+
+/* Clock. shim_set_time() jumps without firing anything; shim_advance*()
+ * moves forward, firing due AppTimers and tick service callbacks (at
+ * minute boundaries) in time order. */
+void shim_set_time(time_t utc);
+void shim_advance(uint32_t seconds);
+void shim_advance_ms(uint64_t ms);
+
+/* Connection and battery, delivered to the subscribed handlers. */
+void shim_set_bt(bool connected);
+void shim_set_battery(uint8_t charge_percent, bool is_charging);
+
+/* Inbox: write a message into the returned iterator, then deliver it. A
+ * message larger than the app's inbound size is dropped, as on the watch. */
+DictionaryIterator *shim_inbox_begin(void);
+void shim_inbox_deliver(void);
+
+/* Outbox. A sent message stays pending (app_message_outbox_begin() is
+ * BUSY) until the test acks or nacks it, which calls the sent or failed
+ * callback. shim_outbox_fail_next() makes the next send fail synchronously
+ * with `result`. Every accepted message is recorded; shim_outbox_message()
+ * opens recorded message `index` (0 = first) for reading. */
+bool shim_outbox_pending(DictionaryIterator *out);
+void shim_outbox_ack(void);
+void shim_outbox_nack(AppMessageResult reason);
+void shim_outbox_fail_next(AppMessageResult result);
+int shim_outbox_count(void);
+bool shim_outbox_message(int index, DictionaryIterator *out);
+
+/* Persistent storage writes so far, across launches (flash wear). */
+uint32_t shim_persist_writes(void);
+
+/* Buttons: call the handler the top window subscribed for `button`. */
+void shim_click(ButtonId button);
+
+/* Display. Text layers are listed in creation order; shim_text_shown() is
+ * true when a visible text layer shows exactly `text`. shim_render() draws
+ * a frame if any layer is dirty. */
+int shim_text_layer_count(void);
+TextLayer *shim_text_layer(int index);
+const char *shim_text_layer_text(const TextLayer *text_layer);
+bool shim_text_shown(const char *text);
+void shim_render(void);
+int shim_live_layers(void);
+
+/* Cost counters of this process. */
+typedef struct {
+  uint32_t text_layout_calls; /* graphics_text_layout_get_content_size() */
+  uint32_t draw_text_calls;   /* graphics_draw_text() */
+  uint32_t frame_sets;        /* layer_set_frame() */
+  uint32_t dirty_marks;       /* layer_mark_dirty(), including by TextLayer setters */
+  uint32_t text_sets;         /* text_layer_set_text() */
+  uint32_t frames;            /* shim_render() passes that redrew */
+  uint32_t outbox_sends;      /* app_message_outbox_send(), accepted or not */
+  uint32_t timers_registered;
+  uint32_t timers_fired;
+  uint32_t ticks_delivered;   /* tick service callbacks */
+} shim_stats_t;
+
+const shim_stats_t *shim_stats(void);
+void shim_reset_stats(void);
+
+/* Log records per level in this process. Records are printed to stderr when
+ * SHIM_LOG is set in the environment. */
+uint32_t shim_log_count(AppLogLevel level);
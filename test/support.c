@@ -0,0 +1,86 @@
+#include "support.h"
+#include "counters.h"
+#include "event_bus.h"
+#include "msg_router.h"
+#include "tick_dispatch.h"
+
+/* REQUEST_WEATHER, see weather.c */
+#define WEATHER_REQUEST_KEY 100
+
+uint32_t support_fnv1a(const void *data, size_t len) {
+  const uint8_t *p = data;
+  uint32_t h = 2166136261u;
+  while (len--) {
+    h ^= *p++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+void support_pack(uint8_t out[WEATHER_PACKED_V1_SIZE], int temp, int humidity, int min, int max,
+                  uint8_t icon, const char *city) {
+  uint32_t hash = support_fnv1a(city, strlen(city));
+  const uint8_t record[WEATHER_PACKED_V1_SIZE] = {
+    WEATHER_PACKED_VERSION, (uint8_t)temp, (uint8_t)humidity, (uint8_t)min, (uint8_t)max,
+    0xFF, 0xFF, 0xFF, 0xFF, icon,
+    hash & 0xFF, (hash >> 8) & 0xFF, (hash >> 16) & 0xFF, hash >> 24,
+  };
+  memcpy(out, record, sizeof(record));
+}
+
+void support_send_packed(const uint8_t record[WEATHER_PACKED_V1_SIZE], const char *city) {
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_PACKED, record, WEATHER_PACKED_V1_SIZE);
+  if (city) dict_write_cstring(iter, MESSAGE_KEY_CITY, city);
+  shim_inbox_deliver();
+}
+
+/* Delta of `record` against `base`, see weather.h */
+static void send_delta(const uint8_t base[WEATHER_PACKED_V1_SIZE], const uint8_t record[WEATHER_PACKED_V1_SIZE]) {
+  uint8_t delta[WEATHER_DELTA_HEADER_SIZE + WEATHER_PACKED_V1_SIZE];
+  uint32_t hash = support_fnv1a(base, WEATHER_PACKED_V1_SIZE);
+  uint16_t mask = 0;
+  size_t len = WEATHER_DELTA_HEADER_SIZE;
+  for (int i = 1; i < WEATHER_PACKED_V1_SIZE; ++i) {
+    if (record[i] == base[i]) continue;
+    mask |= 1 << i;
+    delta[len++] = record[i];
+  }
+  delta[0] = WEATHER_PACKED_VERSION;
+  delta[1] = hash & 0xFF;
+  delta[2] = (hash >> 8) & 0xFF;
+  delta[3] = (hash >> 16) & 0xFF;
+  delta[4] = hash >> 24;
+  delta[5] = mask & 0xFF;
+  delta[6] = mask >> 8;
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_DELTA, delta, (uint16_t)len);
+  shim_inbox_deliver();
+}
+
+bool support_phone_answer(uint8_t phone_record[WEATHER_PACKED_V1_SIZE],
+                          const uint8_t record[WEATHER_PACKED_V1_SIZE]) {
+  DictionaryIterator pending;
+  if (!shim_outbox_pending(&pending)) return false;
+  bool is_request = dict_find(&pending, WEATHER_REQUEST_KEY) != NULL;
+  const Tuple *acked = dict_find(&pending, MESSAGE_KEY_SNAPSHOT_HASH);
+  uint32_t acked_hash = acked ? acked->value->uint32 : 0;
+  shim_outbox_ack();
+  if (!is_request) return false;
+  if (acked_hash && acked_hash == support_fnv1a(phone_record, WEATHER_PACKED_V1_SIZE)) {
+    send_delta(phone_record, record);
+  } else {
+    support_send_packed(record, NULL);
+  }
+  memcpy(phone_record, record, WEATHER_PACKED_V1_SIZE);
+  return true;
+}
+
+void support_start_weather(weather_update_callback cb) {
+  counters_init();
+  event_bus_init();
+  msg_router_init();
+  app_message_open(256, 256);
+  tick_dispatch_init();
+  weather_init(cb, NULL);
+}
@@ -0,0 +1,33 @@
+/* support.h
+ * Companion-side helpers shared by the host tests: building the weather
+ * payloads of weather.h, a fake phone answering the watch's requests, and
+ * starting the weather module without the face around it.
+ */
+
+#pragma once
+
+#include "pebble_shim.h"
+#include "message_keys.auto.h"
+#include "weather.h"
+
+/* 32-bit FNV-1a, as fnv1a() in weather.c and src/pkjs/index.js. */
+uint32_t support_fnv1a(const void *data, size_t len);
+
+/* A version 1 packed record (weather.h) without sun times. */
+void support_pack(uint8_t out[WEATHER_PACKED_V1_SIZE], int temp, int humidity, int min, int max,
+                  uint8_t icon, const char *city);
+
+/* Deliver a full WEATHER_PACKED message, with CITY when `city` is set. */
+void support_send_packed(const uint8_t record[WEATHER_PACKED_V1_SIZE], const char *city);
+
+/* The companion's side of one exchange: if a weather request is pending,
+ * ack it and answer with `record`, as a delta when the request acknowledged
+ * `*phone_record` and in full otherwise; `*phone_record` becomes `record`.
+ * Non-weather messages are acked and ignored. Returns true if a request
+ * was answered. */
+bool support_phone_answer(uint8_t phone_record[WEATHER_PACKED_V1_SIZE],
+                          const uint8_t record[WEATHER_PACKED_V1_SIZE]);
+
+/* Start the services the weather module needs and the module itself, as
+ * the face's init does, with `cb` as its update callback. */
+void support_start_weather(weather_update_callback cb);
@@ -0,0 +1,99 @@
+/* Memory figures: runs the face through init, window load, font loads and
+   a day of weather updates, asks for the MEMORY_REPORT the way the
+   companion does and checks the decoded figures against the module's own
+   and against the memory budget. The heap is the shim's model of the SDK's
+   allocations (see pebble_shim.c), so the figures track the face's
+   allocations; stack depths are the host's. */
+
+#include "check.h"
+#include "support.h"
+#include "mem_stats.h"
+
+/* Budgets, basalt. Heap: the face's window, layers and custom fonts. Stack:
+   the app's whole stack is 2 KB on the watch, and host frames are larger
+   than ARM ones, so staying under it here leaves room there */
+#define HEAP_BUDGET (4 * 1024)
+#define STACK_BUDGET (2 * 1024)
+
+static const char *const s_checkpoint_names[MEM_CHECKPOINT_COUNT] = {
+  "init", "window load", "font load", "weather update",
+};
+
+static uint32_t read_u32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static void report_day(void) {
+  uint8_t phone_record[WEATHER_PACKED_V1_SIZE] = {0};
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  for (int hour = 0; hour < 24; ++hour) {
+    support_pack(record, 10 + hour % 12, 60, 10, 23, (hour >= 6 && hour < 21) ? 0 : 9, "Berlin");
+    support_send_packed(record, hour == 0 ? "Berlin" : NULL);
+    shim_advance(60 * 60);
+    support_phone_answer(phone_record, record);
+  }
+  CHECK(!shim_outbox_pending(NULL));
+
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_uint8(iter, MESSAGE_KEY_MEMORY_REPORT, 1);
+  shim_inbox_deliver();
+
+  DictionaryIterator sent;
+  CHECK(shim_outbox_pending(&sent));
+  const Tuple *t = dict_find(&sent, MESSAGE_KEY_MEMORY_REPORT);
+  CHECK(t != NULL);
+  if (!t) return;
+  CHECK_EQ(t->type, TUPLE_BYTE_ARRAY);
+  CHECK_EQ(t->length, MEM_REPORT_SIZE);
+  const uint8_t *report = t->value->data;
+  CHECK_EQ(report[0], MEM_REPORT_VERSION);
+  CHECK_EQ(report[1], MEM_CHECKPOINT_COUNT);
+
+  printf("memory (modeled heap of %u bytes):\n", (unsigned)SHIM_HEAP_SIZE);
+  printf("  %-15s %6s %6s %8s %8s %6s %7s\n", "checkpoint", "used", "free", "used_max", "free_min", "stack",
+         "samples");
+  for (int i = 0; i < MEM_CHECKPOINT_COUNT; ++i) {
+    const uint8_t *e = report + 2 + i * MEM_REPORT_ENTRY_SIZE;
+    uint32_t used = read_u32(e), free_bytes = read_u32(e + 4);
+    uint32_t used_max = read_u32(e + 8), free_min = read_u32(e + 12);
+    uint16_t stack_max = read_u16(e + 16), samples = read_u16(e + 18);
+    printf("  %-15s %6u %6u %8u %8u %6u %7u\n", s_checkpoint_names[i], (unsigned)used, (unsigned)free_bytes,
+           (unsigned)used_max, (unsigned)free_min, (unsigned)stack_max, (unsigned)samples);
+
+    // The report carries the module's figures as they were when it was sent
+    const mem_checkpoint_stats_t *stats = mem_stats_get(i);
+    CHECK_EQ(used, stats->heap_used);
+    CHECK_EQ(used_max, stats->heap_used_max);
+    CHECK_EQ(free_min, stats->heap_free_min);
+    CHECK_EQ(samples, stats->samples);
+    CHECK(samples > 0);
+    CHECK_EQ(used + free_bytes, SHIM_HEAP_SIZE);
+    CHECK(used <= used_max);
+    CHECK(free_min <= free_bytes);
+
+    CHECK(used_max <= HEAP_BUDGET);
+    CHECK(stack_max > 0);
+    CHECK(stack_max <= STACK_BUDGET);
+  }
+  // The window loads during init (window_stack_push()), and updates
+  // allocate nothing lasting
+  const uint8_t *init = report + 2;
+  const uint8_t *loaded = report + 2 + MEM_CHECKPOINT_WINDOW_LOAD * MEM_REPORT_ENTRY_SIZE;
+  const uint8_t *updated = report + 2 + MEM_CHECKPOINT_WEATHER_UPDATE * MEM_REPORT_ENTRY_SIZE;
+  CHECK_EQ(read_u32(init), read_u32(loaded));
+  CHECK_EQ(read_u32(updated), read_u32(loaded));
+  shim_outbox_ack();
+}
+
+static void test_memory_report(void) {
+  CHECK(shim_run_app(report_day));
+}
+
+int main(void) {
+  RUN(test_memory_report);
+  return check_failures();
+}
@@ -0,0 +1,141 @@
+/* Sunrise/sunset accuracy: solar_compute() against reference times for a
+   spread of latitudes, longitudes (both sides of the date line) and seasons.
+   The reference is NOAA's Solar Calculator algorithm (Meeus, with nutation
+   and the full equation of time) evaluated in double precision, for the
+   same 0.833 degree horizon; times are minutes after UTC midnight of the
+   date, so they run negative or past 1440 far east and west. The shim's
+   trig is exact, so this measures the formula and the integer math, not
+   the watch's lookup tables. */
+
+#include "check.h"
+#include "solar.h"
+
+#define NONE 0x7FFF /* polar day or night */
+
+typedef struct {
+  int32_t lat_e4, lon_e4;
+  int year, month, day;
+  int sunrise, sunset; /* minutes after UTC midnight */
+} solar_reference_t;
+
+static const solar_reference_t s_reference[] = {
+  /* Berlin */
+  {  525200,   134050, 2000,  1,  1,   437,   902 },
+  {  525200,   134050, 2026,  3, 20,   309,  1039 },
+  {  525200,   134050, 2026,  6, 21,   163,  1173 },
+  {  525200,   134050, 2026,  9, 23,   294,  1023 },
+  {  525200,   134050, 2026, 12, 21,   435,   894 },
+  {  525200,   134050, 2035,  8,  1,   206,  1139 },
+  /* New York */
+  {  407128,  -740060, 2000,  1,  1,   740,  1299 },
+  {  407128,  -740060, 2026,  3, 20,   659,  1388 },
+  {  407128,  -740060, 2026,  6, 21,   565,  1471 },
+  {  407128,  -740060, 2026,  9, 23,   645,  1371 },
+  {  407128,  -740060, 2026, 12, 21,   737,  1292 },
+  {  407128,  -740060, 2035,  8,  1,   593,  1452 },
+  /* Quito */
+  {   -1807,  -784678, 2000,  1,  1,   673,  1401 },
+  {   -1807,  -784678, 2026,  3, 20,   678,  1404 },
+  {   -1807,  -784678, 2026,  6, 21,   672,  1399 },
+  {   -1807,  -784678, 2026,  9, 23,   663,  1389 },
+  {   -1807,  -784678, 2026, 12, 21,   668,  1396 },
+  {   -1807,  -784678, 2035,  8,  1,   677,  1403 },
+  /* Sydney */
+  { -338688,  1512093, 2000,  1,  1,  -313,   549 },
+  { -338688,  1512093, 2026,  3, 20,  -242,   487 },
+  { -338688,  1512093, 2026,  6, 21,  -180,   414 },
+  { -338688,  1512093, 2026,  9, 23,  -256,   472 },
+  { -338688,  1512093, 2026, 12, 21,  -319,   545 },
+  { -338688,  1512093, 2035,  8,  1,  -192,   435 },
+  /* Auckland */
+  { -368485,  1747633, 2000,  1,  1,  -415,   463 },
+  { -368485,  1747633, 2026,  3, 20,  -337,   393 },
+  { -368485,  1747633, 2026,  6, 21,  -266,   312 },
+  { -368485,  1747633, 2026,  9, 23,  -350,   378 },
+  { -368485,  1747633, 2026, 12, 21,  -422,   460 },
+  { -368485,  1747633, 2035,  8,  1,  -280,   335 },
+  /* Honolulu */
+  {  213069, -1578583, 2000,  1,  1,  1029,  1681 },
+  {  213069, -1578583, 2026,  3, 20,   995,  1723 },
+  {  213069, -1578583, 2026,  6, 21,   950,  1756 },
+  {  213069, -1578583, 2026,  9, 23,   981,  1706 },
+  {  213069, -1578583, 2026, 12, 21,  1025,  1675 },
+  {  213069, -1578583, 2035,  8,  1,   965,  1750 },
+  /* Reykjavik */
+  {  641466,  -219426, 2000,  1,  1,   680,   942 },
+  {  641466,  -219426, 2026,  3, 20,   449,  1183 },
+  {  641466,  -219426, 2026,  6, 21,   175,  1444 },
+  {  641466,  -219426, 2026,  9, 23,   434,  1165 },
+  {  641466,  -219426, 2026, 12, 21,   682,   929 },
+  {  641466,  -219426, 2035,  8,  1,   274,  1352 },
+  /* Ushuaia */
+  { -548019,  -683030, 2000,  1,  1,   480,  1513 },
+  { -548019,  -683030, 2026,  3, 20,   635,  1366 },
+  { -548019,  -683030, 2026,  6, 21,   779,  1211 },
+  { -548019,  -683030, 2026,  9, 23,   619,  1353 },
+  { -548019,  -683030, 2026, 12, 21,   471,  1511 },
+  { -548019,  -683030, 2035,  8,  1,   742,  1257 },
+  /* Tromsø */
+  {  696492,   189553, 2000,  1,  1,  NONE,  NONE },
+  {  696492,   189553, 2026,  3, 20,   284,  1022 },
+  {  696492,   189553, 2026,  6, 21,  NONE,  NONE },
+  {  696492,   189553, 2026,  9, 23,   268,  1003 },
+  {  696492,   189553, 2026, 12, 21,  NONE,  NONE },
+  {  696492,   189553, 2035,  8,  1,    20,  1275 },
+};
+#define REFERENCE_COUNT ((int)(sizeof(s_reference) / sizeof(s_reference[0])))
+
+/* solar.h promises about a minute; allow for rounding on both sides. Near
+   the polar circles the sun grazes the horizon, and taking the declination
+   at noon rather than at the crossing itself moves the times by minutes */
+static int tolerance(int32_t lat_e4) {
+  return (lat_e4 > 600000 || lat_e4 < -600000) ? 10 : 2;
+}
+
+static void test_days_from_civil(void) {
+  CHECK_EQ(solar_days_from_civil(1970, 1, 1), 0);
+  CHECK_EQ(solar_days_from_civil(2000, 1, 1), 10957);
+  CHECK_EQ(solar_days_from_civil(2000, 3, 1), 11017); // leap day before
+  CHECK_EQ(solar_days_from_civil(2100, 3, 1), 47541); // no leap day before
+  CHECK_EQ(solar_days_from_civil(2026, 6, 21), SHIM_DEFAULT_TIME / 86400);
+  CHECK_EQ(solar_days_from_civil(1969, 12, 31), -1);
+}
+
+static void test_reference_times(void) {
+  int worst = 0;
+  for (int i = 0; i < REFERENCE_COUNT; ++i) {
+    const solar_reference_t *ref = &s_reference[i];
+    int32_t day = solar_days_from_civil(ref->year, ref->month, ref->day);
+    solar_times_t times;
+    bool rises = solar_compute(ref->lat_e4, ref->lon_e4, day, &times);
+    if (ref->sunrise == NONE) {
+      CHECK(!rises);
+      CHECK_EQ(times.sunrise, 0);
+      CHECK_EQ(times.sunset, 0);
+      continue;
+    }
+    CHECK(rises);
+    if (!rises) continue;
+    time_t midnight = (time_t)day * 86400;
+    int rise_error = (int)(times.sunrise - midnight - ref->sunrise * 60);
+    int set_error = (int)(times.sunset - midnight - ref->sunset * 60);
+    int limit = tolerance(ref->lat_e4) * 60;
+    if (abs(rise_error) > limit || abs(set_error) > limit) {
+      fprintf(stderr, "  %d,%d %04d-%02d-%02d: sunrise off %+ds, sunset off %+ds\n", (int)ref->lat_e4,
+              (int)ref->lon_e4, ref->year, ref->month, ref->day, rise_error, set_error);
+    }
+    CHECK(abs(rise_error) <= limit);
+    CHECK(abs(set_error) <= limit);
+    if (abs(ref->lat_e4) <= 600000) {
+      if (abs(rise_error) > worst) worst = abs(rise_error);
+      if (abs(set_error) > worst) worst = abs(set_error);
+    }
+  }
+  printf("solar: %d reference days, worst error below 60 degrees %ds\n", REFERENCE_COUNT, worst);
+}
+
+int main(void) {
+  RUN(test_days_from_civil);
+  RUN(test_reference_times);
+  return check_failures();
+}
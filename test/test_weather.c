@@ -0,0 +1,470 @@
+/* Weather module and face logic: payload decoding, the request pipeline,
+   the refresh policy, staleness and what the face shows for them. */
+
+#include "check.h"
+#include "support.h"
+#include "counters.h"
+#include "layout.h"
+
+#define WEATHER_REQUEST_KEY 100
+#define PERSIST_KEY_DARK_MODE 1
+
+static int s_updates = 0;
+
+static void on_update(const weather_data_t *data, void *ctx) {
+  s_updates++;
+}
+
+/* Hash the request pending in the outbox acknowledges, or -1 without one */
+static int64_t pending_request_hash(void) {
+  DictionaryIterator iter;
+  if (!shim_outbox_pending(&iter) || !dict_find(&iter, WEATHER_REQUEST_KEY)) return -1;
+  const Tuple *t = dict_find(&iter, MESSAGE_KEY_SNAPSHOT_HASH);
+  return t ? (int64_t)t->value->uint32 : -1;
+}
+
+static void test_packed_payload(void) {
+  support_start_weather(on_update);
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  support_send_packed(record, "Berlin");
+  const weather_data_t *w = weather_get();
+  CHECK_EQ(w->temp, 21);
+  CHECK_EQ(w->humidity, 58);
+  CHECK_EQ(w->min, 15);
+  CHECK_EQ(w->max, 24);
+  CHECK_STR(w->icon_code, "01d");
+  CHECK_STR(w->city, "Berlin");
+  CHECK_EQ(s_updates, 1);
+  CHECK_EQ(weather_get_updated_at(), SHIM_DEFAULT_TIME);
+
+  // The same record again changes nothing
+  support_send_packed(record, NULL);
+  CHECK_EQ(s_updates, 1);
+  CHECK_STR(w->city, "Berlin");
+}
+
+static void test_delta_payload(void) {
+  support_start_weather(on_update);
+  uint8_t phone[WEATHER_PACKED_V1_SIZE], record[WEATHER_PACKED_V1_SIZE];
+  support_pack(phone, 21, 58, 15, 24, 0, "Berlin");
+  support_send_packed(phone, "Berlin");
+
+  weather_force_request();
+  CHECK_EQ(pending_request_hash(), support_fnv1a(phone, sizeof(phone)));
+  support_pack(record, 23, 58, 15, 25, 0, "Berlin");
+  CHECK(support_phone_answer(phone, record));
+  CHECK_EQ(weather_get()->temp, 23);
+  CHECK_EQ(weather_get()->max, 25);
+  CHECK_STR(weather_get()->city, "Berlin");
+  CHECK_EQ(counters_get(COUNTER_DELTAS_APPLIED), 1);
+
+  // The next request acknowledges the patched record
+  weather_force_request();
+  CHECK_EQ(pending_request_hash(), support_fnv1a(record, sizeof(record)));
+}
+
+static void test_truncated_delta_keeps_record(void) {
+  support_start_weather(on_update);
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  support_send_packed(record, "Berlin");
+  uint32_t hash = support_fnv1a(record, sizeof(record));
+
+  // Mask says temperature and humidity changed, but only one byte follows
+  const uint8_t truncated[] = {
+    WEATHER_PACKED_VERSION, hash & 0xFF, (hash >> 8) & 0xFF, (hash >> 16) & 0xFF, hash >> 24,
+    (1 << 1) | (1 << 2), 0, 30,
+  };
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_DELTA, truncated, sizeof(truncated));
+  shim_inbox_deliver();
+  CHECK_EQ(weather_get()->temp, 21);
+  CHECK_EQ(counters_get(COUNTER_DELTAS_APPLIED), 0);
+
+  // The applied record is untouched, so a good delta against it still applies
+  weather_force_request();
+  CHECK_EQ(pending_request_hash(), hash);
+  uint8_t updated[WEATHER_PACKED_V1_SIZE];
+  support_pack(updated, 19, 58, 15, 24, 0, "Berlin");
+  CHECK(support_phone_answer(record, updated));
+  CHECK_EQ(weather_get()->temp, 19);
+  CHECK_EQ(counters_get(COUNTER_DELTAS_APPLIED), 1);
+}
+
+static void test_delta_base_mismatch(void) {
+  support_start_weather(on_update);
+  uint8_t record[WEATHER_PACKED_V1_SIZE], other[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  support_send_packed(record, "Berlin");
+  support_pack(other, 5, 90, 2, 7, 3, "Oslo");
+
+  // A delta against a record the watch never had asks for a full one
+  weather_force_request();
+  shim_outbox_ack();
+  uint32_t hash = support_fnv1a(other, sizeof(other));
+  const uint8_t delta[] = {
+    WEATHER_PACKED_VERSION, hash & 0xFF, (hash >> 8) & 0xFF, (hash >> 16) & 0xFF, hash >> 24, 1 << 1, 0, 30,
+  };
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_DELTA, delta, sizeof(delta));
+  shim_inbox_deliver();
+  CHECK_EQ(weather_get()->temp, 21);
+  CHECK_EQ(counters_get(COUNTER_DELTA_MISMATCHES), 1);
+  CHECK_EQ(pending_request_hash(), 0);
+}
+
+static void test_requests_coalesce_and_time_out(void) {
+  support_start_weather(on_update);
+  weather_force_request();
+  CHECK_EQ(shim_outbox_count(), 1);
+  shim_outbox_ack();
+
+  // In flight until the reply: further triggers merge into it
+  weather_force_request();
+  CHECK_EQ(shim_outbox_count(), 1);
+  CHECK_EQ(counters_get(COUNTER_REQUESTS_COALESCED), 1);
+
+  // No reply within the response timeout: retry after the policy's base delay
+  shim_advance(60);
+  CHECK_EQ(counters_get(COUNTER_RESPONSE_TIMEOUTS), 1);
+  shim_advance(weather_get_policy()->retry_base_seconds - 1);
+  CHECK_EQ(shim_outbox_count(), 1);
+  shim_advance(1);
+  CHECK_EQ(shim_outbox_count(), 2);
+}
+
+static void test_retry_backoff(void) {
+  support_start_weather(on_update);
+  const weather_policy_t *policy = weather_get_policy();
+  uint32_t delay = policy->retry_base_seconds;
+
+  // Every attempt is refused by the outbox: delays double up to the cap
+  shim_outbox_fail_next(APP_MSG_BUSY);
+  weather_force_request();
+  CHECK_EQ(counters_get(COUNTER_WEATHER_REQUESTS), 1);
+  for (uint32_t attempt = 2; attempt <= 5; ++attempt) {
+    shim_outbox_fail_next(APP_MSG_BUSY);
+    shim_advance(delay - 1);
+    CHECK_EQ(counters_get(COUNTER_WEATHER_REQUESTS), attempt - 1);
+    shim_advance(1);
+    CHECK_EQ(counters_get(COUNTER_WEATHER_REQUESTS), attempt);
+    delay = delay * 2 < policy->retry_max_seconds ? delay * 2 : policy->retry_max_seconds;
+  }
+  CHECK_EQ(counters_get(COUNTER_OUTBOX_FAILED), 5);
+  CHECK_EQ(shim_outbox_count(), 0);
+}
+
+static void test_retry_waits_for_bt(void) {
+  support_start_weather(on_update);
+  shim_set_bt(false);
+  weather_force_request();
+  shim_outbox_nack(APP_MSG_NOT_CONNECTED);
+  uint32_t timers = counters_get(COUNTER_WEATHER_TIMERS);
+
+  // Deferred without timers while disconnected, sent on reconnect
+  shim_advance(60 * 60);
+  CHECK_EQ(counters_get(COUNTER_WEATHER_TIMERS), timers);
+  CHECK_EQ(shim_outbox_count(), 1);
+  shim_set_bt(true);
+  CHECK_EQ(shim_outbox_count(), 2);
+  CHECK(pending_request_hash() >= 0);
+}
+
+static void test_cooldown(void) {
+  support_start_weather(on_update);
+  uint8_t phone[WEATHER_PACKED_V1_SIZE] = { 0 }, record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  CHECK(weather_request());
+  CHECK(support_phone_answer(phone, record));
+
+  shim_advance(weather_get_policy()->cooldown_seconds - 1);
+  CHECK(!weather_request());
+  CHECK_EQ(counters_get(COUNTER_COOLDOWN_SKIPS), 1);
+  shim_advance(1);
+  CHECK(weather_request());
+}
+
+static void test_policy_limits(void) {
+  support_start_weather(on_update);
+  weather_policy_t p = {
+    .poll_minutes = 15,
+    .cooldown_seconds = 60 * 60,
+    .retry_base_seconds = 1,
+    .retry_max_seconds = 65535,
+    .max_retries = 200,
+  };
+  CHECK(weather_set_policy(&p));
+  const weather_policy_t *policy = weather_get_policy();
+  CHECK_EQ(policy->poll_minutes, 15);
+  CHECK_EQ(policy->cooldown_seconds, 9 * 60); // below the 10 min floor
+  CHECK_EQ(policy->retry_base_seconds, 10);
+  CHECK_EQ(policy->retry_max_seconds, 60 * 60);
+  CHECK_EQ(policy->max_retries, 16);
+
+  // From the settings page: keys missing from the message keep their value
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_int32(iter, MESSAGE_KEY_POLL_MINUTES, 5);
+  dict_write_int32(iter, MESSAGE_KEY_REQUEST_COOLDOWN, 100000);
+  shim_inbox_deliver();
+  CHECK_EQ(policy->poll_minutes, 10);
+  CHECK_EQ(policy->cooldown_seconds, 9 * 60);
+  CHECK_EQ(policy->max_retries, 16);
+}
+
+/* Runs the poll for `minutes`, the phone answering every request with a
+   temperature `step` degrees on from the last; returns requests sent */
+static uint32_t poll_for(int minutes, int *temp, int step) {
+  uint8_t phone[WEATHER_PACKED_V1_SIZE] = { 0 }, record[WEATHER_PACKED_V1_SIZE];
+  uint32_t before = counters_get(COUNTER_WEATHER_REQUESTS);
+  for (int i = 0; i < minutes; ++i) {
+    support_pack(record, *temp, 58, 5, 30, 0, "Berlin");
+    if (support_phone_answer(phone, record)) *temp += step;
+    shim_advance(60);
+  }
+  support_pack(record, *temp, 58, 5, 30, 0, "Berlin");
+  if (support_phone_answer(phone, record)) *temp += step;
+  return counters_get(COUNTER_WEATHER_REQUESTS) - before;
+}
+
+static void test_volatile_cadence_sends(void) {
+  support_start_weather(on_update);
+  weather_policy_t p = *weather_get_policy();
+  p.poll_minutes = 60;
+  p.cooldown_seconds = 60 * 60;
+  CHECK(weather_set_policy(&p));
+  CHECK_EQ(weather_get_policy()->cooldown_seconds, 29 * 60); // below the volatile 30 min
+
+  // Temperatures jumping 3 degrees per answer halve the interval once there
+  // is a baseline to compare with, and the cooldown lets every shortened
+  // poll through
+  int temp = 10;
+  weather_start_periodic(60);
+  CHECK_EQ(poll_for(60, &temp, 3), 1);
+  CHECK_EQ(weather_get_poll_interval(), 30);
+  CHECK_EQ(weather_get_poll_reason(), WEATHER_POLL_REASON_VOLATILE);
+  CHECK_EQ(poll_for(3 * 60, &temp, 3), 3 * 60 / 30);
+  CHECK_EQ(counters_get(COUNTER_COOLDOWN_SKIPS), 0);
+}
+
+/* Forecast of `count` slots `step` minutes apart from `first` */
+static void send_forecast(time_t first, int count, int step, int temp) {
+  uint8_t forecast[WEATHER_FORECAST_HEADER_SIZE + WEATHER_FORECAST_SLOTS * 3] = {
+    WEATHER_FORECAST_VERSION, (uint8_t)count,
+    first & 0xFF, (first >> 8) & 0xFF, (first >> 16) & 0xFF, (first >> 24) & 0xFF,
+    step & 0xFF, step >> 8,
+  };
+  for (int i = 0; i < count; ++i) {
+    forecast[WEATHER_FORECAST_HEADER_SIZE + i * 3] = (uint8_t)(temp + i);
+    forecast[WEATHER_FORECAST_HEADER_SIZE + i * 3 + 1] = 1;
+  }
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_FORECAST, forecast, WEATHER_FORECAST_HEADER_SIZE + count * 3);
+  shim_inbox_deliver();
+}
+
+/* Packed record with sun times in UTC minutes of the day */
+static void send_with_sun(int temp, uint16_t rise_min, uint16_t set_min) {
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, temp, 58, 15, 24, 0, "Berlin");
+  record[5] = rise_min & 0xFF;
+  record[6] = rise_min >> 8;
+  record[7] = set_min & 0xFF;
+  record[8] = set_min >> 8;
+  support_send_packed(record, NULL);
+}
+
+static void check_poll(uint16_t minutes, uint8_t reason) {
+  CHECK_EQ(weather_get_poll_interval(), minutes);
+  CHECK_EQ(weather_get_poll_reason(), reason);
+}
+
+static void test_poll_interval_reasons(void) {
+  const uint16_t day = WEATHER_PACKED_NO_TIME;
+  support_start_weather(on_update);
+  weather_start_periodic(20);
+  check_poll(20, WEATHER_POLL_REASON_BASE);
+  send_with_sun(20, day, day); // first payload: no baseline, not volatile
+  check_poll(20, WEATHER_POLL_REASON_BASE);
+
+  // Unchanged payloads stretch the interval, up to four times the base
+  send_with_sun(20, day, day);
+  check_poll(40, WEATHER_POLL_REASON_STABLE);
+  send_with_sun(20, day, day);
+  send_with_sun(20, day, day);
+  send_with_sun(20, day, day);
+  check_poll(80, WEATHER_POLL_REASON_STABLE);
+
+  // A jump halves it; a small change goes back to the base
+  send_with_sun(23, day, day);
+  check_poll(10, WEATHER_POLL_REASON_VOLATILE);
+  send_with_sun(24, day, day);
+  check_poll(20, WEATHER_POLL_REASON_BASE);
+
+  // Low battery doubles it, critical quadruples it, charging lifts both;
+  // each as soon as the level changes
+  shim_set_battery(15, false);
+  check_poll(40, WEATHER_POLL_REASON_LOW_BATTERY);
+  shim_set_battery(5, false);
+  check_poll(80, WEATHER_POLL_REASON_LOW_BATTERY);
+  shim_set_battery(5, true);
+  check_poll(20, WEATHER_POLL_REASON_BASE);
+
+  // Between sunset and sunrise it triples; it is 12:00 UTC, so a sunset at
+  // 06:00 and sunrise at 18:00 make it night
+  send_with_sun(25, 18 * 60, 6 * 60);
+  check_poll(60, WEATHER_POLL_REASON_NIGHT);
+  send_with_sun(26, 6 * 60, 18 * 60);
+  check_poll(20, WEATHER_POLL_REASON_BASE);
+
+  // Stacked reasons are capped at two hours
+  shim_set_battery(5, false);
+  send_with_sun(27, 18 * 60, 6 * 60);
+  check_poll(120, WEATHER_POLL_REASON_LOW_BATTERY | WEATHER_POLL_REASON_NIGHT | WEATHER_POLL_REASON_CAPPED);
+
+  // A forecast timeline ahead replaces the interval with its top-up period
+  shim_set_battery(80, false);
+  send_with_sun(28, 6 * 60, 18 * 60);
+  send_forecast(time(NULL) + 60 * 60, 4, 60, 10);
+  send_with_sun(29, 6 * 60, 18 * 60);
+  check_poll(360, WEATHER_POLL_REASON_TIMELINE);
+}
+
+static void test_staleness(void) {
+  support_start_weather(on_update);
+  uint8_t record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  CHECK(!weather_is_stale()); // nothing yet
+  support_send_packed(record, "Berlin");
+  shim_advance(2 * 60 * 60);
+  CHECK(!weather_is_stale());
+  shim_advance(60);
+  CHECK(weather_is_stale());
+
+  // A fresh payload with a forecast: slots ahead keep it fresh, and each
+  // slot reached ages from its start
+  support_send_packed(record, NULL);
+  time_t now = time(NULL);
+  send_forecast(now + 60 * 60, 4, 60, 10);
+  shim_advance(4 * 60 * 60 + 60);
+  CHECK_EQ(weather_get()->temp, 13);
+  CHECK(!weather_is_stale());
+  shim_advance(2 * 60 * 60);
+  CHECK(weather_is_stale());
+}
+
+/* Face */
+
+static void face_receives_weather(void) {
+  uint8_t phone[WEATHER_PACKED_V1_SIZE] = { 0 }, record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  // Launch forces a request; the phone answers it
+  CHECK(support_phone_answer(phone, record));
+  CHECK(shim_text_shown("21°C"));
+  CHECK(shim_text_shown("58%"));
+  CHECK(shim_text_shown("15-24°"));
+  CHECK(shim_text_shown("01d"));
+
+  // Centered between the humidity and min/max frames at its measured width,
+  // or on the screen where they leave no gap (basalt's overlap by 2px)
+  TextLayer *temp = NULL;
+  for (int i = 0; i < shim_text_layer_count(); ++i) {
+    if (strcmp(shim_text_layer_text(shim_text_layer(i)), "21°C") == 0) temp = shim_text_layer(i);
+  }
+  CHECK(temp);
+  const face_layout_t *layout = layout_get();
+  int gap_left = layout->humidity.origin.x + layout->humidity.size.w;
+  int gap = layout->minmax.origin.x - gap_left;
+  GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+  int width = graphics_text_layout_get_content_size("21°C", font, GRect(0, 0, 144, 20),
+                                                    GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft).w;
+  int x;
+  if (gap > 0) {
+    if (width > gap) width = gap;
+    x = gap_left + (gap - width) / 2;
+  } else {
+    x = 144 / 2 - width / 2;
+  }
+  GRect frame = layer_get_frame(text_layer_get_layer(temp));
+  CHECK_EQ(frame.size.w, width);
+  CHECK_EQ(frame.origin.x, x);
+  CHECK_EQ(frame.origin.y, layout->temperature.origin.y);
+
+  // Without updates the temperature is marked stale
+  weather_set_stale_age(60 * 60);
+  shim_advance(60 * 60 + 60);
+  CHECK(shim_text_shown("21°C*"));
+  CHECK_EQ(shim_log_count(APP_LOG_LEVEL_ERROR), 0);
+
+  // Passes with nothing to redraw are not counted as updates
+  uint32_t updates = counters_get(COUNTER_UPDATES);
+  CHECK(updates > 0);
+  send_forecast(time(NULL) - 3 * 60 * 60, 2, 60, 30); // passed slots: notifies, nothing to show
+  CHECK_EQ(counters_get(COUNTER_UPDATES), updates);
+}
+
+static void test_face_shows_weather(void) {
+  CHECK(shim_run_app(face_receives_weather));
+}
+
+static void face_dark_mode(void) {
+  // DARK_MODE is 10012; BT_CONNECTED (10009) must not touch it
+  CHECK_EQ(MESSAGE_KEY_DARK_MODE, 10012);
+  DictionaryIterator *iter = shim_inbox_begin();
+  dict_write_int32(iter, MESSAGE_KEY_BT_CONNECTED, 1);
+  shim_inbox_deliver();
+  CHECK(!persist_exists(PERSIST_KEY_DARK_MODE));
+  iter = shim_inbox_begin();
+  dict_write_cstring(iter, MESSAGE_KEY_DARK_MODE, "0");
+  shim_inbox_deliver();
+  CHECK(persist_exists(PERSIST_KEY_DARK_MODE));
+  CHECK_EQ(persist_read_int(PERSIST_KEY_DARK_MODE), 0);
+}
+
+static void test_face_dark_mode(void) {
+  CHECK(shim_run_app(face_dark_mode));
+}
+
+static void face_first_launch(void) {
+  CHECK_EQ(weather_get_startup_stats()->forced, 1);
+  uint8_t phone[WEATHER_PACKED_V1_SIZE] = { 0 }, record[WEATHER_PACKED_V1_SIZE];
+  support_pack(record, 21, 58, 15, 24, 0, "Berlin");
+  CHECK(support_phone_answer(phone, record));
+}
+
+static void face_relaunch(void) {
+  // The snapshot is shown right away and the first poll waits out the
+  // rest of the interval
+  CHECK_EQ(weather_get_startup_stats()->fast_path, 1);
+  CHECK(shim_text_shown("21°C"));
+  CHECK_EQ(shim_outbox_count(), 0);
+  shim_advance((weather_get_poll_interval() - 5) * 60 - 1);
+  CHECK_EQ(shim_outbox_count(), 0);
+  shim_advance(1);
+  CHECK_EQ(shim_outbox_count(), 1);
+}
+
+static void test_face_relaunch_fast_path(void) {
+  CHECK(shim_run_app(face_first_launch));
+  shim_advance(5 * 60);
+  CHECK(shim_run_app(face_relaunch));
+}
+
+int main(void) {
+  RUN(test_packed_payload);
+  RUN(test_delta_payload);
+  RUN(test_truncated_delta_keeps_record);
+  RUN(test_delta_base_mismatch);
+  RUN(test_requests_coalesce_and_time_out);
+  RUN(test_retry_backoff);
+  RUN(test_retry_waits_for_bt);
+  RUN(test_cooldown);
+  RUN(test_policy_limits);
+  RUN(test_volatile_cadence_sends);
+  RUN(test_poll_interval_reasons);
+  RUN(test_staleness);
+  RUN(test_face_shows_weather);
+  RUN(test_face_dark_mode);
+  RUN(test_face_relaunch_fast_path);
+  return check_failures();
+}